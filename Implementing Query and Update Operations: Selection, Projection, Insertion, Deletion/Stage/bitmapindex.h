@@ -0,0 +1,196 @@
+#ifndef BITMAPINDEX_H
+#define BITMAPINDEX_H
+
+#include "index.h"
+#include "predicate.h"
+
+// A compressed bitmap of record positions, in the word-aligned hybrid
+// (WAH) code.  The bits are taken 31 at a time; a group of 31 is kept
+// as a literal word (top bit 0) holding them, unless it is part of a
+// run of groups whose bits are all 0s or all 1s, which a single fill
+// word (top bit 1) stands for: bit 30 of a fill is the bit of its
+// groups, the low 30 bits their number.  Sparse bitmaps are thus
+// mostly fills of 0s, a word for each run between set bits.
+
+const unsigned int WAHFILL = 0x80000000;	// a fill word
+const unsigned int WAHONES = 0x40000000;	// a fill of 1s
+const unsigned int WAHCOUNT = 0x3fffffff;	// groups of a fill
+const unsigned int WAHLITERAL = 0x7fffffff;	// bits of a literal
+const int WAHGROUPBITS = 31;
+
+// positions a heap page gets in a bitmap: record rid is bit
+// rid.pageNo * BITMAPPAGESLOTS + rid.slotNo, so that bits come in
+// page order.  No page holds more records than it has bytes
+const int BITMAPPAGESLOTS = PAGESIZE;
+
+class Bitmap
+{
+public:
+    Bitmap();
+
+    // set, or clear, bit pos.  false if it was so already
+    const bool set(const int pos);
+    const bool clear(const int pos);
+
+    const bool test(const int pos) const;
+
+    // return number of bits set
+    const int getSetCnt() const;
+
+    // make out the AND (conj true) or the OR of bitmaps a and b
+    static void combine(const Bitmap & a, const Bitmap & b, const bool conj,
+                        Bitmap & out);
+
+    // start a walk of the bits set, in order
+    void startScan();
+
+    // return the next bit set, or false if there are no more
+    const bool scanNext(int & pos);
+
+    const vector<unsigned int> & getWords() const;
+
+    // take the words of a bitmap written out by getWords()
+    void setWords(const vector<unsigned int> & w);
+
+private:
+    vector<unsigned int> words;
+    int		groupCnt;	// groups the words stand for
+    int		setCnt;		// bits set
+
+    int		scanWord;	// word the walk is on
+    int		scanStart;	// first group of that word
+    int		scanGroup;	// group the walk is on
+    int		scanBit;	// next bit of the group
+
+    // append a fill of n groups, or one literal group
+    void appendFill(const bool ones, const int n);
+    void appendLiteral(const unsigned int bits);
+
+    // append what word w stands for
+    void appendWord(const unsigned int w);
+
+    // change group g, of word k, which starts at group first, to
+    // the literal bits
+    void replaceGroup(const int k, const int first, const int g,
+                      const unsigned int bits);
+
+    // change bit pos to on.  false if it was so already
+    const bool setBit(const int pos, const bool on);
+};
+
+
+// A bitmap index keeps a bitmap of the records holding each distinct
+// value of an attribute.  It suits attributes with few distinct
+// values: the values are looked up one by one, and a scan for an
+// operator other than EQ goes through the bitmaps of every value that
+// satisfies it.  The values and the first pages of their bitmaps, and
+// the words of each bitmap, are kept in chains of pages.  The bitmaps
+// are read in when first needed and written back, with the values,
+// by flush() or when the index is closed.  A value stays in the index
+// once entered, even if its records are all deleted.
+
+// words a page of a chain holds
+const int BITMAPPAGEWORDS = (PAGESIZE - 2 * sizeof(int)) / sizeof(int);
+
+struct BitmapHdrPage
+{
+  int		keyType;	// Datatype of the keys
+  int		keyLen;		// length of the keys
+  int		entryCnt;	// number of entries, that is bits set
+  int		valueCnt;	// number of distinct values
+  int		dirPage;	// first page of the values, -1 if none
+};
+
+struct BitmapPage
+{
+  int		nextPage;	// next page of the chain, -1 for none
+  int		wordCnt;	// words used
+  unsigned int	words[BITMAPPAGEWORDS];
+};
+
+// create an empty index on keys of the given type and length
+const Status createBitmapIndex(const string & fileName,
+                               const Datatype type,
+                               const int keyLen);
+
+// destroy an index
+const Status destroyBitmapIndex(const string & fileName);
+
+
+class BitmapIndex : public Index
+{
+public:
+
+    // open an index, keeping its header page pinned and reading in
+    // its values
+    BitmapIndex(const string & fileName, Status & status);
+
+    // writes back the bitmaps changed
+    ~BitmapIndex();
+
+    const Status insertEntry(const char* value, const RID & rid);
+
+    const Status deleteEntry(const char* value, const RID & rid);
+
+    // start a scan for the entries whose key satisfies "key op
+    // value", for any op.  the entries of each value come in page
+    // order
+    const Status startScan(const char* value, const Operator op);
+
+    const Status scanNext(RID & outRid);
+
+    const Status scanNextEntry(RID & outRid, char* key);
+
+    const Status endScan();
+
+    const int getEntryCnt() const;
+
+    // return number of distinct values
+    const int getValueCnt() const;
+
+    // make bits the OR of the bitmaps of the values that satisfy
+    // "key op value"
+    const Status getBitmap(const char* value, const Operator op,
+                           Bitmap & bits);
+
+    // write the bitmaps changed and the values to their pages
+    const Status flush();
+
+private:
+    File*	filePtr;	// underlying DB File object
+    BitmapHdrPage* headerPage;	// pinned header page
+    int		headerPageNo;
+    bool	hdrDirtyFlag;
+    CompareFn	keyCmp;		// compares two keys
+    vector<char> keys;		// the values, keyLen bytes each
+    vector<int>	firstPages;	// first page of the bitmap of each
+    vector<Bitmap*> bitmaps;	// bitmap of each, NULL until read in
+    vector<bool> dirty;		// has it changed?
+    bool	dirDirtyFlag;	// have the values?
+
+    bool	scanning;
+    MatchFn	scanMatch;	// the operator of the scan
+    char*	scanValue;	// and its value
+    int		scanValueNo;	// value the scan is on, valueCnt if none
+
+    // the key of value i
+    const char* keyOf(const int i) const;
+
+    // the value with key key, or -1
+    const int findValue(const char* key) const;
+
+    // read in the bitmap of value i
+    const Status loadBitmap(const int i);
+
+    // the words of the chain starting at pageNo
+    const Status readChain(const int pageNo, vector<unsigned int> & w);
+
+    // write w to the chain starting at pageNo, which is extended,
+    // shortened or started as need be
+    const Status writeChain(int & pageNo, const vector<unsigned int> & w);
+
+    // on to the next value of the scan that satisfies it
+    const Status nextScanValue();
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include "index.h"
+
+// A Bloom filter on an attribute of a relation tells that a value is
+// held by none of its records, without reading any of them.  It is
+// blocked: a key picks one page of bits by its hash and sets hashCnt
+// bits of that page, so a lookup or an insert reads a single page.
+// Keys are never taken out, so the filter may say that a value is
+// held when its records have gone, but never that it is not when it
+// is.  The filter is sized when built for twice the records the
+// relation has then; as more keys go in, more lookups of absent
+// values pass, until the filter is built again.  Keys are made and
+// hashed as index keys are.
+
+// fewest keys a filter is sized for
+const int BLOOMMINKEYS = 1024;
+
+// bits of a page of the filter
+const int BLOOMPAGEBITS = PAGESIZE * 8;
+
+struct BloomHdrPage
+{
+  int		keyType;	// Datatype of the keys
+  int		keyLen;		// length of the keys
+  int		hashCnt;	// bits each key sets
+  int		firstPage;	// first page of bits; the others follow it
+  int		pageCnt;	// number of pages of bits
+  int		capacity;	// keys the filter was sized for
+  int		keyCnt;		// keys that went in
+};
+
+// name of the file holding the Bloom filter of an attribute
+const string filterFileName(const string & relation, const string & attrName);
+
+// create an empty filter on keys of the given type and length, sized
+// for keyCnt keys at bitsPerKey bits each
+const Status createBloomFilter(const string & fileName,
+                               const Datatype type,
+                               const int keyLen,
+                               const int keyCnt,
+                               const int bitsPerKey);
+
+// destroy a filter
+const Status destroyBloomFilter(const string & fileName);
+
+
+class BloomFilter
+{
+public:
+
+    // open a filter, keeping its header page pinned
+    BloomFilter(const string & fileName, Status & status);
+
+    ~BloomFilter();
+
+    // add the key of attribute value value
+    const Status insertKey(const char* value);
+
+    // add the keys of the values at offset of n records, going to
+    // each page once
+    const Status insertKeys(const Record recs[], const int n,
+                            const int offset);
+
+    // see if a record may hold value.  false means none does
+    const Status mayContain(const char* value, bool & found);
+
+    // return number of keys that went in
+    const int getKeyCnt() const;
+
+    // return number of keys the filter was sized for
+    const int getCapacity() const;
+
+private:
+    File*	filePtr;	// underlying DB File object
+    BloomHdrPage* headerPage;	// pinned header page
+    int		headerPageNo;
+    bool	hdrDirtyFlag;
+
+    // hash of the key makeIndexKey() makes of a value
+    const unsigned long long keyHash(const char* value) const;
+
+    // page number of the bits of a key with hash h
+    const int pageOf(const unsigned long long h) const;
+
+    // set the bits of a key with hash h on page, or see if they are
+    void setBits(unsigned char* page, const unsigned long long h) const;
+    const bool testBits(const unsigned char* page,
+                        const unsigned long long h) const;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef BTREE_H
+#define BTREE_H
+
+#include "index.h"
+
+// define if debug output wanted
+//#define DEBUGIND
+
+// A B+-tree index maps the values of one attribute of a relation to
+// the RIDs of the records holding them.  Its file has a header page
+// and node pages.  Leaves hold (key, RID) entries in ascending order
+// and are chained left to right; inner nodes hold a child page number
+// followed by (key, RID, child) separators, the child of a separator
+// holding the entries at or above it.  Since the RID is part of the
+// entry every entry is distinct, and values that occur many times
+// split like any other.  Keys are the attribute values, STRING values
+// padded with NULs to the attribute length.  Deleted entries leave
+// their space behind: nodes are not merged, and an empty leaf stays
+// in the chain until the index is built again.
+
+// most levels an index can grow to
+const int MAXBTREEHEIGHT = 16;
+
+// bytes of a node page that hold entries
+const int BTREENODEBYTES = PAGESIZE - 4 * sizeof(int);
+
+// (key, RID) pairs a bulk build sorts in memory at a time
+const int BTREESORTITEMS = 10000;
+
+struct BTreeHdrPage
+{
+  int		rootPage;	// page number of the root node
+  int		height;		// levels of nodes, 1 if the root is a leaf
+  int		keyType;	// Datatype of the keys
+  int		keyLen;		// length of the keys
+  int		entryCnt;	// number of entries in the leaves
+  int		leafCnt;	// number of leaves
+  int		firstLeaf;	// page number of the leftmost leaf
+};
+
+struct BTreeNode
+{
+  int		level;		// 0 for leaves, the parent of level
+				// n nodes is on level n + 1
+  int		entryCnt;	// number of entries or separators
+  int		nextPage;	// leaves: the next leaf, -1 for none
+  int		firstChild;	// inner nodes: the child below the
+				// first separator
+  char		entries[BTREENODEBYTES];
+};
+
+// create an empty index on keys of the given type and length
+const Status createBTree(const string & fileName,
+                         const Datatype type,
+                         const int keyLen);
+
+// destroy an index
+const Status destroyBTree(const string & fileName);
+
+
+class BTreeIndex : public Index
+{
+public:
+
+    // open an index, keeping its header page pinned
+    BTreeIndex(const string & fileName, Status & status);
+
+    ~BTreeIndex();
+
+    // add an entry for the record rid with the attribute value at
+    // value.  NONUNIQUEENTRY if the index has it already
+    const Status insertEntry(const char* value, const RID & rid);
+
+    // remove the entry of the record rid with the attribute value
+    // at value.  RECNOTFOUND if there is none
+    const Status deleteEntry(const char* value, const RID & rid);
+
+    // start a scan for the entries whose key satisfies "key op
+    // value" (any operator but NE), in key order
+    const Status startScan(const char* value, const Operator op);
+
+    // start a scan for the entries with keys from lowValue up to
+    // highValue, either of which may be NULL for no bound, and
+    // which are part of the range if the flag next to them is set
+    const Status startScan(const char* lowValue, const bool lowInclusive,
+                           const char* highValue, const bool highInclusive);
+
+    // return the RID of the next entry of the scan, or NOMORERECS
+    const Status scanNext(RID & outRid);
+
+    // return the RID and the key of the next entry of the scan
+    const Status scanNextEntry(RID & outRid, char* key);
+
+    // terminate the scan
+    const Status endScan();
+
+    // fill the empty index with an entry for every record of
+    // relation, whose attribute is at offset.  the (key, RID) pairs
+    // are sorted and written to the leaves left to right, each leaf
+    // filled to fillFactor (0 < fillFactor <= 1) of its capacity,
+    // while the nodes above them are built in the same pass
+    const Status bulkLoad(const string & relation, const int offset,
+                          const double fillFactor);
+
+    // return number of entries in the index
+    const int getEntryCnt() const;
+
+    // return number of levels of the index
+    const int getHeight() const;
+
+    // return number of leaves of the index
+    const int getLeafCnt() const;
+
+private:
+    File*	filePtr;	// underlying DB File object
+    BTreeHdrPage* headerPage;	// pinned header page
+    int		headerPageNo;
+    bool	hdrDirtyFlag;
+    CompareFn	keyCmp;		// compares two keys
+    int		leafEntryLen;	// bytes of a leaf entry
+    int		innerEntryLen;	// bytes of a separator
+
+    BTreeNode*	scanPage;	// leaf the scan is on, NULL if none
+    int		scanPageNo;
+    int		scanPos;	// next entry of the scan on scanPage
+    bool	scanDone;	// the scan has passed its high bound
+    char*	highKey;	// high bound of the scan
+    bool	hasHigh;
+    bool	highInclusive;
+
+    // a bulk build in progress: the rightmost node of each level,
+    // which stays pinned until the next one of its level is started
+    struct BulkState
+    {
+	int	levels;
+	int	fill[MAXBTREEHEIGHT];	// entries to put in a node
+	int	pageNo[MAXBTREEHEIGHT];
+	BTreeNode* node[MAXBTREEHEIGHT];
+    };
+
+    // compare (key1, rid1) with (key2, rid2), returning < 0, 0 or > 0
+    const int entryCmp(const char* key1, const RID & rid1,
+                       const char* key2, const RID & rid2) const;
+
+    // number of entries that fit in a node of the given level
+    const int capacity(const int level) const;
+
+    // the entry at position pos of a node
+    char* entryAt(BTreeNode* node, const int pos) const;
+
+    // the number of entries of a node that are less than (key, rid)
+    const int lowerBound(BTreeNode* node, const char* key,
+                         const RID & rid) const;
+
+    // the child of an inner node whose entries include (key, rid)
+    const int childFor(BTreeNode* node, const char* key,
+                       const RID & rid) const;
+
+    // find the leaf whose entries include (key, rid), returning the
+    // page numbers of the nodes passed on the way in path, indexed
+    // by level
+    const Status findLeaf(const char* key, const RID & rid, int path[]);
+
+    // add (key, rid, child) to node pageNo, splitting it if it is
+    // full.  split is set if it was, and (sepKey, sepRid, newPageNo)
+    // is then the separator to add to its parent
+    const Status insertInto(const int pageNo, const char* key,
+                            const RID & rid, const int child,
+                            bool & split, char* sepKey, RID & sepRid,
+                            int & newPageNo);
+
+    // append (key, rid, child) to the rightmost node of a level
+    // during a bulk build, starting a new node to its right if the
+    // node is filled, and a new level if the level had one node
+    const Status bulkAppend(BulkState & b, const int level,
+                            const char* key, const RID & rid,
+                            const int child);
+
+    // fill the leaves with the sorted pairs of file pairFile
+    const Status bulkLoadSorted(const string & pairFile,
+                                const double fillFactor);
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef BUF_H
 #define BUF_H
 
+#include <pthread.h>
 #include "db.h"
 // define if debug output wanted
 //#define DEBUGBUF
@@ -97,6 +98,19 @@ struct BufStats
 };
 
 
+// a file that scans are reading from start to end, and the data
+// page position the last of them reported
+struct SharedScan
+{
+  File*	file;
+  int	pos;
+  int	scanCnt;	// scans of the file in progress, 0 if slot unused
+};
+
+// most files scanned cooperatively at the same time
+const int MAXSHAREDSCANS = 16;
+
+
 class BufMgr 
 {
 private:
@@ -105,6 +119,8 @@ private:
   BufHashTbl*    hashTable;  	// hash table mapping (File, page) to frame
   BufDesc*	 bufTable;  	// vector of status info, 1 per page
   BufStats	 bufStats;	// buffer pool statistics
+  pthread_mutex_t bufLatch;	// held by the thread using the pool
+  SharedScan	 sharedScans[MAXSHAREDSCANS]; // files being scanned
 
   const Status allocBuf(int & frame);   // allocate a free frame.  
   const void releaseBuf(int frame); // return unused frame to end of list
@@ -124,10 +140,23 @@ public:
   const Status unPinPage(File* file, const int PageNo, const bool dirty);
   const Status allocPage(File* file, int& PageNo, Page*& page); 
                         // allocates a new, empty page 
+  const Status prefetchPages(File* file, const int pageCnt, const int pageNos[]);
+                        // reads pages ahead, unpinned, in page order
   const Status flushFile(const File* file); // writing out all dirty pages of the file
+
+  // cooperative scans.  a scan of a whole file joins the scans of
+  // the file in progress, learning in pos the data page position
+  // they have reached (-1 if there are none), reports each position
+  // it reads and leaves when it is done.  joinScan returns false if
+  // too many files are being scanned for the scan to join
+  const bool joinScan(File* file, int & pos);
+  void reportScanPos(File* file, const int pos);
+  void leaveScan(File* file);
   const Status disposePage(File* file, const int PageNo); // dispose of page in file
   void  printSelf();
 
+  const int getNumBufs() const { return numBufs; }
+
   const BufStats & getBufStats() const // get buffer pool usage
   {
 	return bufStats;
@@ -10,6 +10,7 @@
 
 #define RELCATNAME   "relcat"           // name of relation catalog
 #define ATTRCATNAME  "attrcat"          // name of attribute catalog
+#define STATCATNAME  "statcat"          // name of statistics catalog
 #define MAXNAME      32                 // length of relName, attrName
 #define MAXSTRINGLEN 255                // max. length of string attribute
 
@@ -17,11 +18,13 @@
 // schema of relation catalog:
 //   relation name : char(32)           <-- lookup key
 //   attribute count : integer(4)
+//   page format : integer(4)  (type is PageFormat actually)
 
 
 typedef struct {
   char relName[MAXNAME];                // relation name
   int attrCnt;                          // number of attributes
+  int pageFormat;                       // SLOTTEDPAGE, FIXEDPAGE or PAXPAGE
 } RelDesc;
 
 
@@ -34,6 +37,19 @@ typedef struct {
 } attrInfo; 
 
 
+// how an attribute is indexed.  The index of attribute a of relation
+// r is kept in the file named by indexFileName(r, a)
+
+enum IndexType { UNINDEXED, BTREEINDEX, HASHINDEX, BITMAPINDEX };
+
+// share of each leaf of a B+-tree filled when the tree is built, which
+// leaves the rest for later inserts
+const double BTREEFILLFACTOR = 0.9;
+
+// bits a Bloom filter gets for each key it is sized for
+const int BLOOMBITSPERKEY = 10;
+
+
 class RelCatalog : public HeapFile {
  public:
   // open relation catalog
@@ -48,14 +64,41 @@ class RelCatalog : public HeapFile {
   // remove tuple from catalog
   const Status removeInfo(const string & relation);
 
-  // create a new relation
+  // create a new relation stored in the default page format
   const Status createRel(const string & relation, 
 		   const int attrCnt, 
 		   const attrInfo attrList[]);
 
+  // create a new relation stored in the given page format
+  const Status createRel(const string & relation, 
+		   const int attrCnt, 
+		   const attrInfo attrList[],
+		   const PageFormat format);
+
   // destroy a relation
   const Status destroyRel(const string & relation);
 
+  // build an index of the given type on an attribute of a relation.
+  // a B+-tree is built bottom-up, its leaves filled to fillFactor
+  const Status addIndex(const string & relation,
+			const string & attrName,
+			const IndexType type,
+			const double fillFactor = BTREEFILLFACTOR);
+
+  // drop the index on an attribute of a relation
+  const Status dropIndex(const string & relation,
+			 const string & attrName);
+
+  // build a Bloom filter on an attribute of a relation, of bitsPerKey
+  // bits for each key it is sized for
+  const Status addFilter(const string & relation,
+			 const string & attrName,
+			 const int bitsPerKey = BLOOMBITSPERKEY);
+
+  // drop the Bloom filter on an attribute of a relation
+  const Status dropFilter(const string & relation,
+			  const string & attrName);
+
   // print catalog information
   const Status help(const string & relation);          // relation may be NULL
 
@@ -70,6 +113,9 @@ class RelCatalog : public HeapFile {
 //   attribute number : integer(4)
 //   attribute type : integer(4)  (type is Datatype actually)
 //   attribute size : integer(4)
+//   index type : integer(4)  (type is IndexType actually)
+//   filtered : integer(4)  (1 if it has a Bloom filter)
+
 
 
 typedef struct {
@@ -78,9 +124,15 @@ typedef struct {
   int attrOffset;                       // attribute offset
   int attrType;                         // attribute type
   int attrLen;                          // attribute length
+  int indexed;                          // IndexType of its index
+  int filtered;                         // has it a Bloom filter?
 } AttrDesc;
 
 
+// name of the file holding the index of an attribute
+const string indexFileName(const string & relation, const string & attrName);
+
+
 class AttrCatalog : public HeapFile {
  friend class RelCatalog;
 
@@ -112,10 +164,70 @@ class AttrCatalog : public HeapFile {
 };
 
 
+// schema of statistics catalog:
+//   relation name : char(32)           <-- lookup keys
+//   attribute name : char(32)          <--
+//   row count, page count : integer(4)
+//   distinct count : float(4)
+//   sampled rows, analyzed pages, bucket count : integer(4)
+//   minimum, maximum : key(8)
+//   histogram bounds : key(8) * (HISTBUCKETS + 1)
+//   distinct count sketch : char(HLLREGISTERS)
+//
+// Keys are INTEGER and FLOAT values and the first STATKEYLEN bytes of
+// STRING values, as in zone maps.  The histogram is equi-depth: about
+// as many rows fall between bounds[i] and bounds[i + 1] as between any
+// other two neighbouring bounds.  The sketch is a HyperLogLog sketch,
+// kept so that ANALYZE can add to it the rows of new pages.
+
+const int STATKEYLEN = ZONEKEYLEN;
+const int HISTBUCKETS = 16;
+const int HLLBITS = 8;                  // sketch register index bits
+const int HLLREGISTERS = 1 << HLLBITS;
+
+typedef struct {
+  char relName[MAXNAME];                // relation name
+  char attrName[MAXNAME];               // attribute name
+  int rowCnt;                           // rows of the relation
+  int pageCnt;                          // data pages of the relation
+  float distinctCnt;                    // estimated distinct values
+  int sampledRows;                      // rows the statistics describe
+  int analyzedPages;                    // data pages examined up to here
+  int bucketCnt;                        // histogram buckets in use
+  char minVal[STATKEYLEN];              // smallest key seen
+  char maxVal[STATKEYLEN];              // largest key seen
+  char bounds[HISTBUCKETS + 1][STATKEYLEN]; // bucket bounds, ascending
+  unsigned char sketch[HLLREGISTERS];   // HyperLogLog registers
+} StatDesc;
+
+
+class StatCatalog : public HeapFile {
+ public:
+  // open statistics catalog
+  StatCatalog(Status &status);
+
+  // get the statistics of an attribute
+  const Status getInfo(const string & relation,
+		       const string & attrName,
+		       StatDesc &record);
+
+  // add the statistics of an attribute, replacing any it had
+  const Status addInfo(StatDesc & record);
+
+  // remove the statistics of an attribute
+  const Status removeInfo(const string & relation, const string & attrName);
+
+  // delete all statistics about a relation
+  const Status dropRelation(const string & relation);
+
+  // close statistics catalog
+  ~StatCatalog();
+};
+
+
 extern RelCatalog  *relCat;
 extern AttrCatalog *attrCat;
+extern StatCatalog *statCat;
 extern Error error;
-extern Status createHeapFile(const string filename);
-extern Status destroyHeapFile(const string filename);
 
 #endif
@@ -1,87 +1,179 @@
+#include <algorithm>
 #include "catalog.h"
 #include "query.h"
+#include "index.h"
+#include "predicate.h"
 
 
 /*
- * Deletes records from a specified relation.
- *
- * Returns:
- * 	OK on success
- * 	an error code otherwise
+ * Deletes the records that satisfy all of predCnt predicates with the
+ * index on the attribute of predicate which.  The RIDs the index has
+ * for that predicate are all collected before any record is deleted,
+ * as deleting changes the index, and the records are then visited in
+ * page order and checked against the other predicates.
  */
 
-const Status QU_Delete(const string & relation, 
-						const string & attrName, 
-						const Operator op,
-						const Datatype type, 
-						const char *attrValue)
+static const Status IndexDelete(const string & relation,
+								const int predCnt,
+								const ScanPredicate preds[],
+								const int which,
+								const AttrDesc & indexAttr)
 {
-	// part 6
-	if (relation.empty()) {
-		return BADCATPARM;
-	}
+	cout << "Deleting with the index on " << indexAttr.attrName << endl;
 
 	Status status;
+	Index *index;
+	vector<RID> rids;
 	RID rid;
-	AttrDesc attrD;
-	HeapFileScan *scanner;
-	int intVal;
-	float floatVal;
+	MatchFn matchFns[predCnt];
+	int tupleCount = 0;
 
-	if (attrName.empty()) {
-		scanner = new HeapFileScan(relation, status);
+	for (int i = 0; i < predCnt; i++) {
+		matchFns[i] = compilePredicate(preds[i].type, preds[i].op);
+	}
+
+	status = openIndex(indexAttr, index);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = index->startScan(preds[which].filter, preds[which].op);
+
+	while (status == OK && (status = index->scanNext(rid)) == OK) {
+		rids.push_back(rid);
+	}
+
+	if (status == NOMORERECS) {
+		status = index->endScan();
+	}
+
+	delete index;
+
+	if (status != OK) {
+		return status;
+	}
+
+	sort(rids.begin(), rids.end(), ridLess);
+
+	RelIndices indices(relation, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	HeapFileScan scanner(relation, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	for (unsigned int k = 0; k < rids.size(); k++) {
+		Record rec;
+		bool match = true;
+
+		status = scanner.getRecord(rids[k], rec);
 
 		if (status != OK) {
 			return status;
 		}
 
-		scanner->startScan(0, 0, STRING, NULL, EQ);
-
-		while ((status = scanner->scanNext(rid)) != FILEEOF) {
-			status = scanner->deleteRecord();
+		for (int i = 0; i < predCnt && match; i++) {
+			match = (*matchFns[i])((char *)rec.data + preds[i].offset,
+								   preds[i].filter, preds[i].length);
+		}
 
-			if (status != OK) {
-				return status;
-			}
+		if (!match) {
+			continue;
 		}
-	} else {
-		scanner = new HeapFileScan(relation, status);
+
+		status = indices.deleteEntries(rec, rids[k]);
 
 		if (status != OK) {
 			return status;
 		}
 
-		status = attrCat->getInfo(relation, attrName, attrD);
+		status = scanner.deleteRecord();
 
 		if (status != OK) {
 			return status;
 		}
 
-		switch (type) {
-			case INTEGER:
-				intVal = atoi(attrValue);
-				status = scanner->startScan(attrD.attrOffset, attrD.attrLen, type, (char *)&intVal, op);
-				
-				break;
-
-			case FLOAT:
-				floatVal = atof(attrValue);
-				status = scanner->startScan(attrD.attrOffset, attrD.attrLen, type, (char *)&floatVal, op);
-				
-				break;
-
-			default:
-				status = scanner->startScan(attrD.attrOffset, attrD.attrLen, type, attrValue, op);
-				
-				break;
-		}
+		tupleCount++;
+	}
+
+	cout << "Deleted " << tupleCount << " tuples from " << rids.size()
+		 << " index entries" << endl;
+
+	return OK;
+}
+
+
+/*
+ * Deletes the records that satisfy all (CONJUNCTION) or any
+ * (DISJUNCTION) of predCnt predicates, with an index if one answers
+ * them and is expected to touch few pages, and with a scan otherwise.
+ * The entries of the deleted records are removed from every index of
+ * the relation.
+ */
+
+static const Status DeleteWhere(const string & relation,
+								const int predCnt,
+								const ScanPredicate preds[],
+								const Connective conn)
+{
+	Status status;
+	Record rec;
+	int which;
+	AttrDesc indexAttr;
+
+	status = QU_ChooseIndex(relation, predCnt, preds, conn, which, indexAttr);
+
+	if (status != OK) {
+		return status;
+	}
+
+	if (which >= 0) {
+		return IndexDelete(relation, predCnt, preds, which, indexAttr);
+	}
+
+	RelIndices indices(relation, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	HeapFileScan scanner(relation, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = scanner.startScan(predCnt, preds, conn);
+
+	if (status != OK) {
+		return status;
+	}
+
+	RID rids[SCANBATCHSIZE];
+	Record recs[SCANBATCHSIZE];
+	int batchCnt;
+
+	// the records come a page at a time, and their index entries are
+	// removed together before the records are
+	while ((status = scanner.scanNextBatch(SCANBATCHSIZE, rids, recs, batchCnt)) == OK) {
+		status = indices.deleteEntries(recs, rids, batchCnt);
 
 		if (status != OK) {
 			return status;
 		}
 
-		while ((status = scanner->scanNext(rid)) == OK) {
-			status = scanner->deleteRecord();
+		for (int i = 0; i < batchCnt; i++) {
+			status = scanner.getRecord(rids[i], rec);
+
+			if (status == OK) {
+				status = scanner.deleteRecord();
+			}
 
 			if (status != OK) {
 				return status;
@@ -93,8 +185,102 @@ const Status QU_Delete(const string & relation,
 		return status;
 	}
 
-	scanner->endScan();
-	delete scanner;
+	return scanner.endScan();
+}
 
-	return OK;
-}
\ No newline at end of file
+
+/*
+ * Deletes records from a specified relation.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_Delete(const string & relation,
+						const string & attrName,
+						const Operator op,
+						const Datatype type,
+						const char *attrValue)
+{
+	// part 6
+	if (relation.empty()) {
+		return BADCATPARM;
+	}
+
+	Status status;
+	AttrDesc attrD;
+	ScanPredicate pred;
+	int intVal;
+	float floatVal;
+
+	if (attrName.empty()) {
+		return DeleteWhere(relation, 0, NULL, CONJUNCTION);
+	}
+
+	status = attrCat->getInfo(relation, attrName, attrD);
+
+	if (status != OK) {
+		return status;
+	}
+
+	switch (type) {
+		case INTEGER:
+			intVal = atoi(attrValue);
+			pred.filter = (char *)&intVal;
+
+			break;
+
+		case FLOAT:
+			floatVal = atof(attrValue);
+			pred.filter = (char *)&floatVal;
+
+			break;
+
+		default:
+			pred.filter = attrValue;
+
+			break;
+	}
+
+	pred.offset = attrD.attrOffset;
+	pred.length = attrD.attrLen;
+	pred.type = type;
+	pred.op = op;
+
+	return DeleteWhere(relation, 1, &pred, CONJUNCTION);
+}
+
+
+/*
+ * Deletes the records of a relation that satisfy all (CONJUNCTION) or
+ * any (DISJUNCTION) of several conditions, in a single scan or with an
+ * index on one of them.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_Delete(const string & relation,
+						const int condCnt,
+						const attrInfo conds[],
+						const Operator ops[],
+						const Connective conn)
+{
+	if (relation.empty()) {
+		return BADCATPARM;
+	}
+
+	Status status;
+	ScanPredicate preds[MAXSCANPREDS];
+	int numbers[MAXSCANPREDS];
+
+	status = QU_MakePredicates(relation, condCnt, conds, ops, preds, numbers);
+
+	if (status != OK) {
+		return status;
+	}
+
+	return DeleteWhere(relation, condCnt, preds, conn);
+}
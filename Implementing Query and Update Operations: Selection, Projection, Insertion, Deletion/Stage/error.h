@@ -45,7 +45,7 @@ enum Status {
 
        BADCATPARM, RELNOTFOUND, ATTRNOTFOUND,
        NAMETOOLONG, DUPLATTR, RELEXISTS, NOINDEX,
-       INDEXEXISTS, ATTRTOOLONG,
+       INDEXEXISTS, ATTRTOOLONG, NOSTATS, NOFILTER, FILTEREXISTS,
 
 // Utility errors
 
@@ -0,0 +1,126 @@
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#include "index.h"
+
+// An extendible hash index answers equality lookups.  The low
+// globalDepth bits of the hash of a key pick a directory entry, which
+// holds the page number of the bucket of the key; a bucket with a
+// localDepth below globalDepth is shared by the 2^(globalDepth -
+// localDepth) entries that agree on its low localDepth bits.  A full
+// bucket is split in two on the next bit of the hash, and the
+// directory doubles when a bucket with localDepth equal to
+// globalDepth splits.  Entries whose hashes are all alike cannot be
+// told apart by splitting, nor can any once the directory is at its
+// largest: those go to overflow pages chained to the bucket.  The
+// directory is kept in memory while the index is open and written to
+// its pages whenever it changes.  Deletes leave buckets as they are,
+// but give back overflow pages that become empty.
+
+// directory pages an index can have, and the entries on each
+const int MAXHASHDIRPAGES = 64;
+const int HASHDIRPAGEENTRIES = PAGESIZE / sizeof(int);
+
+// bytes of a bucket page that hold entries
+const int HASHBUCKETBYTES = PAGESIZE - 3 * sizeof(int);
+
+struct HashHdrPage
+{
+  int		globalDepth;	// bits of the hash the directory uses
+  int		keyType;	// Datatype of the keys
+  int		keyLen;		// length of the keys
+  int		entryCnt;	// number of entries
+  int		bucketCnt;	// number of buckets, without overflow pages
+  int		dirPages[MAXHASHDIRPAGES]; // directory pages, -1 if none
+};
+
+struct HashBucket
+{
+  int		localDepth;	// bits of the hash its keys agree on
+  int		entryCnt;	// number of (key, RID) entries
+  int		nextPage;	// overflow page, -1 for none
+  char		entries[HASHBUCKETBYTES];
+};
+
+// create an empty index on keys of the given type and length
+const Status createHashIndex(const string & fileName,
+                             const Datatype type,
+                             const int keyLen);
+
+// destroy an index
+const Status destroyHashIndex(const string & fileName);
+
+
+class HashIndex : public Index
+{
+public:
+
+    // open an index, keeping its header page pinned
+    HashIndex(const string & fileName, Status & status);
+
+    ~HashIndex();
+
+    const Status insertEntry(const char* value, const RID & rid);
+
+    const Status deleteEntry(const char* value, const RID & rid);
+
+    // start a scan for the entries with key value.  op must be EQ
+    const Status startScan(const char* value, const Operator op);
+
+    const Status scanNext(RID & outRid);
+
+    const Status scanNextEntry(RID & outRid, char* key);
+
+    const Status endScan();
+
+    const int getEntryCnt() const;
+
+    // return number of directory entries
+    const int getDirSize() const;
+
+    // return number of buckets
+    const int getBucketCnt() const;
+
+private:
+    File*	filePtr;	// underlying DB File object
+    HashHdrPage* headerPage;	// pinned header page
+    int		headerPageNo;
+    bool	hdrDirtyFlag;
+    CompareFn	keyCmp;		// compares two keys
+    int		entryLen;	// bytes of an entry
+    int		bucketCap;	// entries per bucket page
+    vector<int>	dir;		// bucket page of each directory entry
+
+    HashBucket*	scanPage;	// page the scan is on, NULL if none
+    int		scanPageNo;
+    int		scanPos;	// next entry of the scan on scanPage
+    char*	scanKey;	// key the scan looks for
+
+    // hash of a key
+    const unsigned int keyHash(const char* key) const;
+
+    // write the directory to its pages
+    const Status writeDir();
+
+    // allocate an empty bucket page
+    const Status newBucket(const int localDepth, int & pageNo);
+
+    // add (key, rid) to a page of the bucket chain starting at
+    // pageNo that has room, or return BUCKETFULL if none has
+    const Status insertInto(const int pageNo, const char* key,
+                            const RID & rid);
+
+    // see if splitting the bucket starting at pageNo can make room
+    // for a key with hash h: it can unless all its keys hash to h
+    const Status canSplit(const int pageNo, const unsigned int h,
+                          bool & split);
+
+    // split the bucket of directory entry d, doubling the directory
+    // if it must.  DIROVERFLOW if the directory cannot grow
+    const Status splitBucket(const int d);
+
+    // append an empty overflow page to the bucket chain at pageNo
+    const Status addOverflow(const int pageNo);
+};
+
+#endif
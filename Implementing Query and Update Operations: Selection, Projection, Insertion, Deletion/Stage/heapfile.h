@@ -24,6 +24,75 @@ const unsigned MAXNAMESIZE = 50;
 enum Datatype { STRING, INTEGER, FLOAT };    // attribute data types
 enum Operator { LT, LTE, EQ, GTE, GT, NE };  // scan operators
 
+// "attr op value" compiled for one datatype and operator, and a
+// three-way comparison of two values compiled for one datatype
+// (see predicate.h)
+typedef bool (*MatchFn)(const char* attr, const char* value, const int length);
+typedef int (*CompareFn)(const char* p1, const char* p2, const int length);
+
+// number of attributes whose layout the file header can describe
+const int MAXHDRATTRS = 32;
+
+// layout of one attribute of the tuples stored in a heap file
+struct FieldDesc
+{
+  short		offset;		// byte offset of attribute in tuple
+  short		length;		// length of attribute
+  short		type;		// datatype of attribute
+};
+
+// The free-space map of a heap file keeps one byte per page number
+// of the file: the number of free bytes on that data page in units
+// of FSMUNIT (0 for pages that are full or are not data pages).
+// Each map page covers FSMPAGEENTRIES page numbers.
+const int FSMUNIT = PAGESIZE / 16;
+const int FSMPAGEENTRIES = PAGESIZE;
+const int MAXFSMPAGES = 16;
+
+struct FSMPage
+{
+  unsigned char	freeClass[FSMPAGEENTRIES]; // free space class per page
+};
+
+// Zone maps summarise the values on each data page: for every
+// attribute described in the file header a zone entry holds the
+// smallest and largest key found on the page.  Keys are the values of
+// INTEGER and FLOAT attributes and the first ZONEKEYLEN bytes of
+// STRING attributes.  An entry is an int ZoneState followed by the
+// minimum and maximum key of each attribute, and each zone page holds
+// the entries of PAGESIZE / entry size consecutive page numbers.  The
+// zone pages are listed in zone directory pages, which cover at least
+// as many page numbers as the free-space map, and pages past them are
+// never skipped.
+const int ZONEKEYLEN = 8;
+const int ZONEDIRENTRIES = PAGESIZE / sizeof(int);
+const int MAXZONEPAGES = 64;
+
+struct ZoneDirPage
+{
+  int		pageNos[ZONEDIRENTRIES]; // zone map pages, -1 if none
+};
+
+enum ZoneState { ZONEUNKNOWN, ZONEVALID, ZONEEMPTY };
+
+// make the key of an attribute value, and compare two keys of an
+// attribute, returning < 0, 0 or > 0
+void zoneKey(const int type, const char* value, const int length, char* key);
+int zoneCmp(const int type, const char* a, const char* b);
+
+// The page directory of a heap file lists the page numbers of its
+// data pages in file order, DIRPAGEENTRIES to a directory page, so
+// that the Nth data page is found without following the page chain.
+// Data pages past what the directory pages can list are reached by
+// following the chain from the last page listed.
+const int DIRPAGEENTRIES = PAGESIZE / sizeof(int);
+const int MAXDIRPAGES = 64;
+
+struct DirPage
+{
+  int		pageNos[DIRPAGEENTRIES]; // data page numbers in file order
+};
+
 struct FileHdrPage
 {
   char		fileName[MAXNAMESIZE];   // name of file
@@ -31,8 +100,87 @@ struct FileHdrPage
   int		lastPage;	// pageNo of last data page in file
   int		pageCnt;	// number of pages
   int		recCnt;		// record count
+  int		pageFormat;	// SLOTTEDPAGE, FIXEDPAGE or PAXPAGE
+  int		recLen;		// tuple width, 0 if not known
+  int		attrCnt;	// number of attributes described in attrs
+  FieldDesc	attrs[MAXHDRATTRS]; // tuple layout, in offset order
+  int		fsmPages[MAXFSMPAGES]; // free-space map pages, -1 if none
+  int		zonePages[MAXZONEPAGES]; // zone directory pages, -1 if none
+  int		dirPages[MAXDIRPAGES]; // page directory pages, -1 if none
+  int		vacuumPos;	// data page the next VACUUM slice resumes at
+};
+
+// one condition "attribute op filter" of a scan
+struct ScanPredicate
+{
+  int		offset;		// byte offset of attribute in tuple
+  int		length;		// length of attribute
+  Datatype	type;		// datatype of attribute
+  const char*	filter;		// comparison value (not copied)
+  Operator	op;		// comparison operator
+};
+
+// how the predicates of a scan combine: all of them must hold, or
+// any one of them
+enum Connective { CONJUNCTION, DISJUNCTION };
+
+// how a scan samples the file: every record is looked at, each
+// record is with a given probability (BERNOULLI), or all records of
+// each data page are with a given probability (SYSTEMSAMPLE), which
+// leaves the other pages unread
+enum SampleMethod { NOSAMPLE, BERNOULLI, SYSTEMSAMPLE };
+
+// number of predicates a scan can take
+const int MAXSCANPREDS = 8;
+
+// number of records callers fetch at a time with scanNextBatch
+const int SCANBATCHSIZE = 64;
+
+// number of data pages a scan reads ahead into the buffer pool
+const int SCANPREFETCH = 8;
+
+// a scan of all of a file joins the other scans of the file in
+// progress if the file has more data pages than 1/SYNCSCANFRACTION of
+// the buffer pool; smaller files stay in the pool anyway
+const int SYNCSCANFRACTION = 4;
+
+// most data pages InsertFileScan::insertBatch appends at a time
+const int MAXAPPENDPAGES = 8;
+
+// counters kept by a HeapFileScan since its last startScan
+struct ScanStats
+{
+  int		pagesScanned;	// data pages whose records were examined
+  int		pagesSkipped;	// data pages ruled out by their zone map
+				// or left out of a SYSTEMSAMPLE sample,
+				// which are not read at all
 };
 
+// called by VACUUM for each tuple it moves, once the tuple has been
+// copied to newRid and before it is removed from oldRid, with the arg
+// given to vacuum.  an error stops the VACUUM
+typedef const Status (*MoveFn)(const Record & rec, const RID & oldRid,
+                               const RID & newRid, void* arg);
+
+// counters of a VACUUM time slice
+struct VacuumStats
+{
+  int		pagesExamined;	// data pages looked at
+  int		tuplesMoved;	// tuples moved off the last page
+  int		pagesReclaimed;	// empty data pages given back to the file
+};
+
+// create a heap file holding tuples made of the attrCnt attributes
+// in attrs (which may be omitted for SLOTTEDPAGE files).  FIXEDPAGE
+// and PAXPAGE files only accept records of exactly the tuple width
+const Status createHeapFile(const string fileName,
+                            const PageFormat format = SLOTTEDPAGE,
+                            const int attrCnt = 0,
+                            const FieldDesc attrs[] = NULL);
+
+// destroy a heap file
+const Status destroyHeapFile(const string fileName);
+
 
 // class definition of heapFile
 class HeapFile {
@@ -46,6 +194,75 @@ protected:
    int   	curPageNo;	// page number of pinned page
    bool  	curDirtyFlag;   // true if page has been updated
    RID   	curRec;         // rid of last record returned
+   char*	tupleBuf;       // PAXPAGE records are assembled here
+
+   FSMPage*	fsmPage;        // pinned free-space map page, if any
+   int		fsmPageNo;      // page number of pinned map page
+   bool		fsmDirtyFlag;   // true if map page has been updated
+   int		fsmHint;        // page number to resume map searches at
+
+   Page*	zonePage;       // pinned zone map page, if any
+   int		zonePageNo;     // page number of pinned zone page
+   bool		zoneDirtyFlag;  // true if zone page has been updated
+   Page*	zoneDirPage;    // pinned zone directory page, if any
+   int		zoneDirPageNo;  // page number of pinned directory page
+   bool		zoneDirDirtyFlag; // true if directory page has been updated
+
+   DirPage*	dirPage;        // pinned page directory page, if any
+   int		dirPageNo;      // page number of pinned directory page
+   bool		dirDirtyFlag;   // true if directory page has been updated
+   int		chainPos;       // data page past the directory last found
+   int		chainPageNo;    // by following the chain, and its number
+
+   // read a record of the pinned page curPage
+   const Status readRecord(const RID & rid, Record & rec,
+                           const int bufIndex = 0);
+
+   // record in the free-space map that page pageNo has freeBytes free
+   const Status setFreeSpace(const int pageNo, const int freeBytes);
+
+   // find a data page with at least needed bytes free according to
+   // the free-space map.  pageNo is -1 if there is none
+   const Status findFreePage(const int needed, int& pageNo);
+
+   // pin the free-space map page covering page numbers
+   // [index*FSMPAGEENTRIES, (index+1)*FSMPAGEENTRIES), allocating it
+   // if create is set.  fsmPage is NULL if it does not exist
+   const Status pinFsmPage(const int index, const bool create);
+
+   // pin the map page whose number is kept in mapPageNo in place of
+   // the map page pinned in page, allocating a zeroed page if there
+   // is none and create is set
+   const Status pinMapPage(int & mapPageNo, const bool create,
+                           Page* & page, int & pageNo, bool & dirtyFlag);
+
+   // return in entry the zone entry of page pageNo, allocating its
+   // zone page if create is set.  entry is NULL if there is none
+   const Status getZoneEntry(const int pageNo, const bool create,
+                             char* & entry);
+
+   // extend the zone entry of page pageNo, pinned in page, to cover
+   // the record rid that was just inserted there
+   const Status widenZone(const int pageNo, Page* page, const RID & rid);
+
+   // recompute the zone entry of page pageNo, pinned in page
+   const Status rebuildZone(const int pageNo, Page* page);
+
+   // find out whether a value of record rid on page pageNo is the
+   // minimum or maximum of its attribute, so that deleting the record
+   // calls for a rebuild of the zone entry
+   const Status zoneBoundary(const int pageNo, Page* page,
+                             const RID & rid, bool & boundary);
+
+   // pin the page directory page with the given index
+   const Status pinDirPage(const int index, const bool create);
+
+   // list page pageNo as data page n (counting from 0) of the file
+   const Status setNthPage(const int n, const int pageNo);
+
+   // take data pages n to n+cnt-1, already unlinked from the page
+   // chain, out of the page directory, moving the pages after them up
+   const Status closeDirGap(const int n, const int cnt);
 
 public:
 
@@ -58,6 +275,13 @@ public:
   // return number of records in file
   const int getRecCnt() const;
 
+  // return number of data pages in file
+  const int getPageCnt() const;
+
+  // return in pageNo the page number of data page n of the file,
+  // counting from 0 in the order scans visit them
+  const Status getNthPage(const int n, int & pageNo);
+
   // given a RID, read record from file, returning pointer and length
   const Status getRecord(const RID &rid, Record & rec);
 };
@@ -78,6 +302,33 @@ public:
                            const char* filter, 
                            const Operator op);
 
+    // start a scan for the records that satisfy all (CONJUNCTION) or
+    // any (DISJUNCTION) of the predCnt predicates in preds.  they are
+    // evaluated most selective first, as observed during the scan,
+    // and evaluation stops as soon as the outcome is known
+    const Status startScan(const int predCnt,
+                           const ScanPredicate preds[],
+                           const Connective conn);
+
+    // limit this and later scans to data pages firstN up to (but not
+    // including) endN of the file, or to the end of the file if endN
+    // is -1.  takes effect when the scan is started
+    const Status setPageRange(const int firstN, const int endN);
+
+    // sample percent (0 < percent <= 100) of the records or pages of
+    // this and later scans.  which ones are chosen depends only on
+    // seed and their RIDs, so the same seed gives the same sample,
+    // also when the file is scanned in parallel.  takes effect when
+    // the scan is started
+    const Status setSample(const SampleMethod method, const double percent,
+                           const unsigned int seed);
+
+    // let this and later scans of the whole file start at the page
+    // other scans of the file are reading and wrap around, so that
+    // they share its reads (the default), or read the file in order.
+    // takes effect when the scan is started
+    const Status setSyncScan(const bool on);
+
     const Status endScan(); // terminate the scan
     const Status markScan(); // save current position of scan
     const Status resetScan(); // reset scan to last marked location
@@ -85,30 +336,121 @@ public:
     // return RID of next record that satisfies the scan 
     const Status scanNext(RID& outRid);
 
+    // return up to maxCnt next records that satisfy the scan, and
+    // their RIDs, in cnt.  the records are taken from a single page
+    // and stay valid until the scan moves on
+    const Status scanNextBatch(const int maxCnt, RID rids[],
+                               Record recs[], int & cnt);
+
+    // like scanNextBatch, but copy fieldCnt fields (given by their
+    // offsets and lengths) of each record one after another into
+    // buf, the fields of a record following those of the one before,
+    // as getFields does
+    const Status scanNextFields(const int maxCnt, RID rids[],
+                                const int fieldCnt, const int offsets[],
+                                const int lengths[], char* buf, int & cnt);
+
     // read current record, returning pointer and length
     const Status getRecord(Record & rec);
 
+    // read the record rid, which becomes the current record, so that
+    // it can be deleted or updated as by a scan
+    using HeapFile::getRecord;
+
+    // copy fieldCnt fields (given by their offsets and lengths) of
+    // the current record one after another into buf.  PAXPAGE
+    // records are not assembled, only the requested fields are read
+    const Status getFields(const int fieldCnt, const int offsets[],
+                           const int lengths[], char* buf);
+
+    // overwrite fieldCnt fields (given by their offsets and lengths)
+    // of the current record in place with the values stored one
+    // after another in buf.  the record keeps its RID and length
+    const Status updateFields(const int fieldCnt, const int offsets[],
+                              const int lengths[], const char* buf);
+
     // delete current record 
     const Status deleteRecord();
 
     // marks current page of scan dirty
     const Status markDirty();
 
+    // counters of the scan since startScan
+    const ScanStats & getScanStats() const { return stats; }
+
 private:
-    int   offset;            // byte offset of filter attribute
-    int   length;            // length of filter attribute
-    Datatype type;           // datatype of filter attribute
-    const char* filter;      // comparison value of filter
-    Operator op;             // comparison operator of filter
+    // a predicate of the scan, compiled, with the number of tuples
+    // it has been evaluated for and the number that satisfied it
+    struct CompiledPred
+    {
+	ScanPredicate pred;
+	MatchFn	matchFn;     // pred compiled for its type and op
+	int	zoneAttr;    // attribute in the file header, or -1
+	double	evalCnt;
+	double	passCnt;
+    };
+
+    int   predCnt;           // number of predicates, 0 if no filter
+    Connective conn;         // how the predicates combine
+    CompiledPred preds[MAXSCANPREDS];
+    int   order[MAXSCANPREDS]; // evaluation order of preds
+    ScanStats stats;         // pages examined and skipped
 
      // The following variables are used to preserve the state
     // of the scan when the method markScan() is invoked.
     // A subsequent invocation of resetScan() will cause the
     // scan to be rolled back to the following
     int   markedPageNo;	// page number of pinned page
+    int   markedPagePos;     // position of that page in the file
+    bool  markedWrapped;     // whether the scan had wrapped around
     RID   markedRec;         // rid of last record returned
 
-    const bool matchRec(const Record & rec) const;
+    int   curPagePos;        // position of curPage among the data pages
+    int   rangeFirst;        // first data page of the scan
+    int   rangeEnd;          // data page the scan stops at, -1 for none
+    int   prefetchPos;       // data pages before this one were read ahead
+    bool  syncScan;          // scans of the whole file join others
+    bool  joined;            // scan has joined others of the file
+    int   startPos;          // data page the scan started at
+    bool  wrapped;           // scan has come back to the first page
+    SampleMethod sampleMethod; // how the file is sampled
+    unsigned int sampleSeed;
+    double sampleLimit;      // hashes below this are in the sample
+
+    // Predicate results for the tuples of a FIXEDPAGE or PAXPAGE
+    // page, computed column-at-a-time when the page is first visited
+    int   evalPageNo;        // page the bits belong to, -1 if none
+    unsigned char matchBits[PAGESIZE / 8]; // one bit per tuple position
+    unsigned char predBits[PAGESIZE / 8];  // bits of a single predicate
+
+    const bool matchRec(const Record & rec);
+    const Status matchCurRec(bool & match);
+    void evalPage();
+
+    // sort the predicates by their observed selectivity
+    void orderPreds();
+
+    // move curRec on to the next record of the current page that
+    // satisfies the scan.  found is false if there is none
+    const Status nextOnPage(bool & found);
+
+    // move the scan to the next data page whose zone entry does not
+    // rule out a match, or return FILEEOF at the end of its range
+    const Status nextPage();
+    const Status zoneRulesOut(const int pageNo, bool & skip);
+
+    // see if a page is to be passed over without being read
+    const Status skipPage(const int pageNo, bool & skip);
+
+    // see if record slotNo of page pageNo (or the whole page, for
+    // slotNo -1) is in the sample
+    const bool inSample(const int pageNo, const int slotNo) const;
+
+    // read the pages from data page pos on into the buffer pool
+    const Status prefetch(const int pos);
+
+    // data page position the scan stops at in its current pass
+    const int passEnd() const;
 };
 
 
@@ -123,6 +465,57 @@ public:
 
     // insert record into file, returning its RID
     const Status insertRecord(const Record & rec, RID& outRid); 
+
+    // insert n records into file, returning their RIDs in rids
+    const Status insertBatch(const Record recs[], const int n, RID rids[]);
+
+private:
+    const Status checkRecord(const Record & rec) const;
+    const Status pinInsertPage();
+
+    // continue on a page with room for rec, appending up to newPages
+    // pages to the file if no page has room
+    const Status nextInsertPage(const Record & rec, const int newPages);
+
+    // append cnt empty pages to the file
+    const Status appendPages(const int cnt, int & firstPageNo);
+};
+
+// Gives the space of deleted tuples back.  Empty data pages are
+// unlinked from the file and disposed of, and the tuples of the last
+// page are moved into earlier pages with room so that it can go too.
+// The work can be split into time slices of a bounded number of
+// pages, and a slice resumes where the previous one stopped.
+
+class VacuumFileScan : public HeapFile
+{
+public:
+
+    VacuumFileScan(const string & name, Status & status);
+
+    ~VacuumFileScan();
+
+    // vacuum at most maxPages data pages (no limit if 0), adding to
+    // stats.  done is set when there is nothing more to reclaim.
+    // moveFn, if given, is called for every tuple moved
+    const Status vacuum(const int maxPages, VacuumStats & stats,
+                        bool & done, MoveFn moveFn = NULL,
+                        void* moveArg = NULL);
+
+private:
+    // see if data page pageNo has no records
+    const Status pageEmpty(const int pageNo, bool & empty);
+
+    // unlink empty data page pageNo, which follows page prevPageNo
+    // (-1 for the first page) in the chain, and dispose of it.  the
+    // page directory is left to closeDirGap
+    const Status removePage(const int pageNo, const int prevPageNo);
+
+    // move the tuples of the last data page into earlier pages,
+    // calling moveFn for each.  drained is set if all of them found
+    // a place
+    const Status drainLastPage(VacuumStats & stats, bool & drained,
+                               MoveFn moveFn, void* moveArg);
 };
 
 #endif
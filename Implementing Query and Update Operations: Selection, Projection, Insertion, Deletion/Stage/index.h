@@ -0,0 +1,141 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include "catalog.h"
+
+// The operations every kind of index has.  An index maps the values
+// of one attribute of a relation to the RIDs of the records holding
+// them; a scan returns the RIDs of the entries whose key satisfies
+// "key op value" for the operators the kind of index can answer, and
+// BADINDEXPARM for the others.
+
+class Index
+{
+public:
+    virtual ~Index() {}
+
+    // add an entry for the record rid with the attribute value at
+    // value.  NONUNIQUEENTRY if the index has it already
+    virtual const Status insertEntry(const char* value, const RID & rid) = 0;
+
+    // remove the entry of the record rid with the attribute value
+    // at value.  RECNOTFOUND if there is none
+    virtual const Status deleteEntry(const char* value, const RID & rid) = 0;
+
+    // start a scan for the entries whose key satisfies "key op value"
+    virtual const Status startScan(const char* value, const Operator op) = 0;
+
+    // return the RID of the next entry of the scan, or NOMORERECS
+    virtual const Status scanNext(RID & outRid) = 0;
+
+    // return the RID and the key of the next entry of the scan, or
+    // NOMORERECS.  the key is the attribute value, STRING values
+    // padded with NULs to the attribute length
+    virtual const Status scanNextEntry(RID & outRid, char* key) = 0;
+
+    // terminate the scan
+    virtual const Status endScan() = 0;
+
+    // return number of entries in the index
+    virtual const int getEntryCnt() const = 0;
+
+protected:
+    Datatype	keyType;	// of the keys, set when the index is opened
+    int		keyLen;		// and their length
+
+    // turn an attribute value into a key with makeIndexKey()
+    void makeKey(const char* value, char* key) const;
+};
+
+
+// turn an attribute value of the given type and length into the key
+// indices and filters keep: STRING values are padded with NULs to the
+// length, and a FLOAT -0.0, which equals 0.0, becomes 0.0 so that
+// equal values have equal keys and hashes
+void makeIndexKey(const Datatype type, const int length,
+		  const char* value, char* key);
+
+
+// see if an index of the given type answers "key op value"
+const bool indexAnswers(const IndexType type, const Operator op);
+
+// open the index on attribute ad, which the caller deletes
+const Status openIndex(const AttrDesc & ad, Index* & index);
+
+
+// entries of inserted records a RelIndices holds back for each index
+// before it enters them
+const int INDEXBATCHENTRIES = 8192;
+
+
+class BloomFilter;
+
+// The indices and Bloom filters of a relation, opened together so
+// that they can be kept up to date as its records are inserted,
+// deleted, changed and moved.  Entries for many records are entered
+// in key order, so that the ones that go to the same index pages are
+// entered together.  The filters only ever gain keys: the values of
+// records inserted or changed.
+
+class RelIndices
+{
+public:
+    RelIndices(const string & relation, Status & status);
+
+    // enters the entries held back
+    ~RelIndices();
+
+    // return number of indexed or filtered attributes
+    const int getIndexCnt() const;
+
+    // add the entries of a record inserted as rid to every index
+    const Status insertEntries(const Record & rec, const RID & rid);
+
+    // add the entries of n records inserted as rids to every index.
+    // they are held back until INDEXBATCHENTRIES of them are, or
+    // until flushEntries()
+    const Status insertEntries(const Record recs[], const RID rids[],
+                               const int n);
+
+    // enter the entries held back
+    const Status flushEntries();
+
+    // remove the entries of the record rid, about to be deleted,
+    // from every index
+    const Status deleteEntries(const Record & rec, const RID & rid);
+
+    // remove the entries of n records, about to be deleted, from
+    // every index
+    const Status deleteEntries(const Record recs[], const RID rids[],
+                               const int n);
+
+    // change the entries of the record rid, whose attribute values
+    // went from those of oldRec to those of newRec, in the indices
+    // of the attributes that changed
+    const Status updateEntries(const Record & oldRec, const Record & newRec,
+                               const RID & rid);
+
+    // change the RID of the entries of a record moved from oldRid to
+    // newRid
+    const Status moveEntries(const Record & rec, const RID & oldRid,
+                             const RID & newRid);
+
+private:
+    vector<AttrDesc> attrs;	// the indexed attributes
+    vector<Index*> indices;	// and their indices
+    vector<AttrDesc> filterAttrs; // the filtered attributes
+    vector<BloomFilter*> filters; // and their filters
+    vector<vector<char> > pending; // entries held back for each index,
+				// the attribute value followed by the RID
+    int		pendingCnt;	// records they are for
+
+    // add the entries of n records to entries, one vector per index
+    void collectEntries(const Record recs[], const RID rids[], const int n,
+                        vector<vector<char> > & entries) const;
+
+    // enter entries in, or remove them from, each index in key order
+    const Status applyEntries(vector<vector<char> > & entries,
+                              const bool insert);
+};
+
+#endif
@@ -1,9 +1,11 @@
 #include "catalog.h"
 #include "query.h"
+#include "index.h"
 
 
 /*
- * Inserts a record into the specified relation.
+ * Inserts a record into the specified relation, and its entries into
+ * the indices of the relation.
  *
  * Returns:
  * 	OK on success
@@ -20,9 +22,9 @@ const Status QU_Insert(const string & relation,
     RID rid;
     int relAttrCnt;
     AttrDesc *attrDesc;
-    int recLen;
+    int recLen = 0;
     int intVal;
-    int floatVal;
+    float floatVal;
 
 	status = attrCat->getRelInfo(relation, relAttrCnt, attrDesc);
 
@@ -75,8 +77,19 @@ const Status QU_Insert(const string & relation,
         }
     }
 
-    resultRel.insertRecord(rec, rid);
+    status = resultRel.insertRecord(rec, rid);
 
-	return OK;
+    if (status == OK) {
+        RelIndices indices(relation, status);
+
+        if (status == OK) {
+            status = indices.insertEntries(rec, rid);
+        }
+    }
+
+    free(rec.data);
+    free(attrDesc);
+
+	return status;
 
 }
\ No newline at end of file
@@ -27,6 +27,14 @@ private:
     HTentry 	*ht; // actual hash table
     int  hash(const char* attr, int attrType); // returns value between 0 and HTSIZE-1
 
+    // compare a stored join attribute value of type T with the one at attr
+    template <Datatype T> bool equals(const JAttrType & value, const char* attr) const;
+
+    // copy the RIDs on chain whose join attribute matches attr into
+    // outRids, returning how many there are
+    template <Datatype T> int matchChain(const joinhashBucket* chain,
+                                         const char* attr, RID* outRids) const;
+
 public:
     joinHashTbl(const int size, const AttrDesc attr);  // constructor
     ~joinHashTbl();
@@ -10,6 +10,13 @@ struct RID{
 
 const RID NULLRID = {-1,-1};
 
+// orders RIDs by page, and by slot within a page, so that records
+// read in this order are read a page at a time
+inline bool ridLess(const RID & a, const RID & b)
+{
+    return a.pageNo < b.pageNo || (a.pageNo == b.pageNo && a.slotNo < b.slotNo);
+}
+
 struct Record
 {
   void* data;
@@ -22,6 +29,16 @@ struct slot_t {
         short	length;  // equals -1 if slot is not in use
 };
 
+// page formats.  SLOTTEDPAGE is the variable-length slotted page
+// described below.  FIXEDPAGE is used by relations whose tuples all
+// have the same width: data[] holds an occupancy bitmap followed by
+// a dense array of tuples, and the slot number of a record is simply
+// its index in that array.  PAXPAGE pages also hold equal-width
+// tuples but store them column-wise: a small column directory, the
+// occupancy bitmap, then one minicolumn per attribute, so a scan
+// that looks at one attribute only touches that minicolumn.
+enum PageFormat { SLOTTEDPAGE, FIXEDPAGE, PAXPAGE };
+
 const unsigned PAGESIZE = 1024;
 const unsigned DPFIXED= sizeof(slot_t)+4*sizeof(short)+2*sizeof(int);
 const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
@@ -33,6 +50,12 @@ const unsigned PAGEDATASIZE = PAGESIZE-DPFIXED+sizeof(slot_t);
 // array cannot be compacted.  Notice, this class does not keep
 // the records align, relying instead on upper levels to take
 // care of non-aligned attributes
+//
+// For FIXEDPAGE and PAXPAGE pages the slot array is not used.
+// slotCnt holds the tuple capacity of the page, freePtr the tuple
+// width and freeSpace the number of bytes in unused tuple positions.
+// A PAXPAGE page starts with its column directory: the number of
+// columns followed by the data[] offset and the width of each column.
 
 class Page {
 private:
@@ -41,14 +64,39 @@ private:
     short	slotCnt; // number of slots in use;
     short	freePtr; // offset of first free byte in data[]
     short	freeSpace; // number of bytes free in data[]
-    short	dummy;	// for alignment purposes
+    short	format;	// SLOTTEDPAGE, FIXEDPAGE or PAXPAGE
     int		nextPage; // forwards pointer
     int		curPage;  // page number of current pointer
 
+    // FIXEDPAGE and PAXPAGE helpers
+    static const int bitmapBytes(const int capacity); // size of bitmap
+    static const int paxDirBytes(const int colCnt);  // size of column dir
+    static const int capacityFor(const PageFormat fmt, const int colCnt,
+                                 const short colLen[]); // tuples per page
+    const char* bitmap() const;                     // occupancy bitmap
+    const bool isUsed(const int slotNo) const;      // occupancy bit set?
+    const int nextUsed(int slotNo) const;           // next set bit or -1
+    void setUsed(const int slotNo, const bool used);
+    char* tuplePtr(const int slotNo) const          // FIXEDPAGE tuple
+    {
+        return (char*) &data[bitmapBytes(slotCnt) + slotNo * freePtr];
+    }
+    const short* paxDir() const { return (const short*) data; }
+    char* paxColumn(const int col) const            // PAXPAGE minicolumn
+    {
+        return (char*) &data[paxDir()[1 + col]];
+    }
+
 public:
     void init(const int pageNo); // initialize a new page
+    // initialize a new page of the given format.  colLen[] holds the
+    // widths of the colCnt attributes of the tuples stored on
+    // FIXEDPAGE and PAXPAGE pages
+    const Status init(const int pageNo, const PageFormat fmt,
+                      const int colCnt, const short colLen[]);
     void dumpPage() const;       // dump contents of a page
 
+    const PageFormat getFormat() const; // returns format of page
     const Status getNextPage(int& pageNo) const; // returns value of nextPage
     const Status setNextPage(const int pageNo); // sets value of nextPage to pageNo
     const short getFreeSpace() const; // returns amount of free space
@@ -68,7 +116,34 @@ public:
     const Status nextRecord (const RID & curRid, RID& nextRid) const;
 
     // returns reference to record with RID rid
+    // (not possible for PAXPAGE pages, use getField instead)
     const Status getRecord(const RID & rid, Record & rec);
+
+    // copies bytes [offset, offset+length) of the record with RID
+    // rid into buf.  works for every page format
+    const Status getField(const RID & rid, const int offset,
+                          const int length, char* buf);
+
+    // overwrites bytes [offset, offset+length) of the record with
+    // RID rid with the bytes in buf.  works for every page format
+    const Status setField(const RID & rid, const int offset,
+                          const int length, const char* buf);
+
+    // returns the address of the field at offset in the first tuple
+    // position of the page and the distance in bytes between that
+    // field in consecutive tuple positions, so the field can be read
+    // for all tuples of the page without fetching records.  only for
+    // FIXEDPAGE and PAXPAGE pages, and a PAXPAGE field must not span
+    // more than one column
+    const Status getColumn(const int offset, const int length,
+                           const char*& base, int& stride) const;
+
+    // returns the tuple capacity of a FIXEDPAGE or PAXPAGE page
+    const int getCapacity() const;
+
+    // returns the occupancy bitmap of a FIXEDPAGE or PAXPAGE page.
+    // bit (i & 7) of byte i >> 3 is set if tuple position i is used
+    const unsigned char* getOccupancy() const;
 };
 
 #endif
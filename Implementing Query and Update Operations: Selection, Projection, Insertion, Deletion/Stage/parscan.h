@@ -0,0 +1,92 @@
+#ifndef PARSCAN_H
+#define PARSCAN_H
+
+#include <pthread.h>
+#include "heapfile.h"
+
+
+// number of data pages a worker claims at a time
+const int MORSELPAGES = 16;
+
+// bytes of result tuples a worker collects before it appends them
+// to the result file
+const int PARSCANBUFSIZE = 16 * PAGESIZE;
+
+// most worker threads a scan runs
+const int MAXSCANTHREADS = 64;
+
+
+// The ParallelScan class scans a heap file with several threads.
+// The data pages are cut into morsels of MORSELPAGES pages which the
+// workers claim from a shared counter, so that a worker that is done
+// early takes on more of the file.  Every worker scans its morsels
+// with a HeapFileScan of its own, evaluates the predicates, projects
+// the qualifying tuples into a buffer of its own and appends the
+// buffer to the result file whenever it fills up.
+
+class ParallelScan {
+ public:
+  ParallelScan(const string & relation,     // heap file to scan
+	       const int threadCnt,          // number of worker threads
+	       Status & status);
+  ~ParallelScan();
+
+  // insert into result the fieldCnt fields (given by their offsets
+  // and lengths) of every tuple that satisfies the predicates, and
+  // return the number of tuples inserted in tupleCnt
+  const Status run(InsertFileScan* result,
+		   const int predCnt,
+		   const ScanPredicate preds[],
+		   const Connective conn,
+		   const int fieldCnt,
+		   const int offsets[],
+		   const int lengths[],
+		   int & tupleCnt);
+
+  // sample the file as HeapFileScan::setSample does.  every worker
+  // picks the same records for a seed, so the sample does not depend
+  // on the number of threads
+  const Status setSample(const SampleMethod method,
+			 const double percent,
+			 const unsigned int seed);
+
+  // pages examined and skipped by all workers during run
+  const ScanStats & getScanStats() const { return stats; }
+
+ private:
+  struct Worker
+  {
+    ParallelScan*	scan;
+    HeapFileScan*	heapScan;  // scan of the worker's morsels
+    char*		buf;       // projected tuples not yet inserted
+    int			bufUsed;   // bytes of buf in use
+    int			tupleCnt;  // tuples found by this worker
+    ScanStats		stats;
+    Status		status;    // outcome of the worker
+  };
+
+  int			threadCnt;
+  Worker		workers[MAXSCANTHREADS];
+  int			pageCnt;       // data pages of the file
+  int			nextMorsel;    // first morsel not claimed yet
+  volatile bool		failed;        // a worker ran into an error
+
+  // what run was asked to do
+  InsertFileScan*	result;
+  int			predCnt;
+  const ScanPredicate*	preds;
+  Connective		conn;
+  int			fieldCnt;
+  const int*		offsets;
+  const int*		lengths;
+  int			tupleLen;
+
+  pthread_mutex_t	resultLatch;   // serializes inserts into result
+  ScanStats		stats;
+
+  static void* workerMain(void* arg);
+  const Status scanMorsels(Worker & w);
+  const Status flush(Worker & w);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef PREDICATE_H
+#define PREDICATE_H
+
+#include <string.h>
+#include "heapfile.h"
+
+// Predicates and comparisons are compiled for each Datatype and
+// Operator from the templates below, so that the type and operator
+// are not looked at again for every tuple.  AttrValue<T>::get reads
+// an attribute value of type T from an unaligned address.
+
+template <Datatype T> struct AttrValue;
+
+template <> struct AttrValue<INTEGER>
+{
+  static inline int get(const char* p) { int v; memcpy(&v, p, sizeof(int)); return v; }
+};
+
+template <> struct AttrValue<FLOAT>
+{
+  static inline float get(const char* p) { float v; memcpy(&v, p, sizeof(float)); return v; }
+};
+
+// a op b.  NE is the complement of EQ, so a NaN is not equal to anything
+template <Operator OP, class V>
+inline bool testOp(const V a, const V b)
+{
+  switch(OP) {
+  case LT:  return a < b;
+  case LTE: return a <= b;
+  case EQ:  return a == b;
+  case GTE: return a >= b;
+  case GT:  return a > b;
+  default:  return !(a == b);
+  }
+}
+
+// attr op value for an attribute of type T and the given length
+template <Datatype T, Operator OP>
+inline bool matchValue(const char* attr, const char* value, const int /* length */)
+{
+  return testOp<OP>(AttrValue<T>::get(attr), AttrValue<T>::get(value));
+}
+
+// STRING attributes compare like strncmp against a NUL terminated value
+template <> inline bool matchValue<STRING, LT>(const char* attr, const char* value, const int length)
+{ return strncmp(attr, value, length) < 0; }
+template <> inline bool matchValue<STRING, LTE>(const char* attr, const char* value, const int length)
+{ return strncmp(attr, value, length) <= 0; }
+template <> inline bool matchValue<STRING, EQ>(const char* attr, const char* value, const int length)
+{ return strncmp(attr, value, length) == 0; }
+template <> inline bool matchValue<STRING, GTE>(const char* attr, const char* value, const int length)
+{ return strncmp(attr, value, length) >= 0; }
+template <> inline bool matchValue<STRING, GT>(const char* attr, const char* value, const int length)
+{ return strncmp(attr, value, length) > 0; }
+template <> inline bool matchValue<STRING, NE>(const char* attr, const char* value, const int length)
+{ return strncmp(attr, value, length) != 0; }
+
+// returns the compiled form of "attribute op value"
+MatchFn compilePredicate(const Datatype type, const Operator op);
+
+// three-way comparison of two attribute values of type T, returning
+// -1, 0 or 1.  STRING values compare byte by byte over length bytes
+template <Datatype T>
+inline int compareValue(const char* p1, const char* p2, const int /* length */)
+{
+  return (AttrValue<T>::get(p1) > AttrValue<T>::get(p2))
+       - (AttrValue<T>::get(p1) < AttrValue<T>::get(p2));
+}
+
+template <> inline int compareValue<STRING>(const char* p1, const char* p2, const int length)
+{
+  int diff = memcmp(p1, p2, length);
+  return (diff > 0) - (diff < 0);
+}
+
+// returns the compiled comparison of two values of the given type
+CompareFn compileComparison(const Datatype type);
+
+// a 64 bit hash of an attribute value of the given type and length,
+// every bit of which depends on all of the value.  STRING values end
+// at their NUL, so that padding does not change the hash
+unsigned long long valueHash(const Datatype type, const char* value,
+                             const int length);
+
+// Evaluates "attribute op value" for the n attribute values found
+// stride bytes apart starting at base, and sets bit (i & 7) of
+// bits[i >> 3] if value i qualifies.  bits must hold (n + 7) / 8
+// bytes.  Values compare the way HeapFileScan compares them: STRING
+// attributes of length bytes like strncmp against the NUL terminated
+// value.  INTEGER and FLOAT comparisons and STRING equality use AVX2
+// or SSE4.1 instructions when the processor has them.
+
+void evalColumn(const Datatype type, const Operator op,
+                const char* base, const int stride, const int length,
+                const int n, const char* value, unsigned char* bits);
+
+#endif
@@ -17,6 +17,54 @@ const Status QU_Select(const string & result,
 		       const Operator op, 
 		       const char *attrValue);
 
+const Status QU_Select(const string & result, 
+		       const int projCnt, 
+		       const attrInfo projNames[],
+		       const int condCnt,
+		       const attrInfo conds[],
+		       const Operator ops[],
+		       const Connective conn,
+		       const SampleMethod sample = NOSAMPLE,
+		       const double percent = 100,
+		       const unsigned int seed = 0);
+
+const Status QU_MakePredicates(const string & relation,
+			       const int condCnt,
+			       const attrInfo conds[],
+			       const Operator ops[],
+			       ScanPredicate preds[],
+			       int numbers[]);
+
+const Status QU_ChooseIndex(const string & relation,
+			    const int predCnt,
+			    const ScanPredicate preds[],
+			    const Connective conn,
+			    int & which,
+			    AttrDesc & indexAttr);
+
+const Status QU_ChooseBitmaps(const string & relation,
+			      const int predCnt,
+			      const ScanPredicate preds[],
+			      const Connective conn,
+			      int & bitmapCnt,
+			      AttrDesc bitmapAttrs[]);
+
+const Status QU_FilterRejects(const string & relation,
+			      const int predCnt,
+			      const ScanPredicate preds[],
+			      const Connective conn,
+			      bool & rejected);
+
+const Status QU_CoveringIndex(const string & relation,
+			      const int projCnt,
+			      const AttrDesc projNames[],
+			      const int predCnt,
+			      const ScanPredicate preds[],
+			      const Connective conn,
+			      bool & covered,
+			      int & which,
+			      AttrDesc & indexAttr);
+
 const Status QU_Join(const string & result, 
 		     const int projCnt, 
 		     const attrInfo projNames[],
@@ -34,4 +82,18 @@ const Status QU_Delete(const string & relation,
 		       const Datatype type, 
 		       const char *attrValue);
 
+const Status QU_Delete(const string & relation, 
+		       const int condCnt,
+		       const attrInfo conds[],
+		       const Operator ops[],
+		       const Connective conn);
+
+const Status QU_Update(const string & relation, 
+		       const int setCnt,
+		       const attrInfo setList[],
+		       const int condCnt,
+		       const attrInfo conds[],
+		       const Operator ops[],
+		       const Connective conn);
+
 #endif
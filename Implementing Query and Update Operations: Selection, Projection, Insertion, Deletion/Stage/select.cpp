@@ -1,16 +1,62 @@
+#include <algorithm>
 #include "catalog.h"
 #include "query.h"
+#include "parscan.h"
+#include "btree.h"
+#include "bitmapindex.h"
+#include "bloom.h"
+#include "predicate.h"
 #include "stdio.h"
 #include "stdlib.h"
 
+extern int ScanThreads;
+
+// number of RIDs an index selection looks up at a time, in page order
+const int INDEXFETCHBATCH = 256;
+
+// an index answers a predicate if the statistics of its attribute
+// estimate that fewer records qualify than the relation has pages
+// divided by this
+const int INDEXPAGEFRACTION = 4;
+
 // forward declaration
 const Status ScanSelect(const string & result, 
 							const int projCnt, 
 							const AttrDesc projNames[],
-							const AttrDesc *attrDesc, 
-							const Operator op, 
-							const char *filter,
-							const int reclen);
+							const int predCnt,
+							const ScanPredicate preds[],
+							const Connective conn,
+							const int reclen,
+							const SampleMethod sample,
+							const double percent,
+							const unsigned int seed);
+
+const Status IndexSelect(const string & result, 
+							const int projCnt, 
+							const AttrDesc projNames[],
+							const int predCnt,
+							const ScanPredicate preds[],
+							const int reclen,
+							const int which,
+							const AttrDesc & indexAttr);
+
+const Status IndexOnlySelect(const string & result, 
+							const int projCnt, 
+							const AttrDesc projNames[],
+							const int predCnt,
+							const ScanPredicate preds[],
+							const int reclen,
+							const int which,
+							const AttrDesc & indexAttr);
+
+const Status BitmapSelect(const string & result, 
+							const int projCnt, 
+							const AttrDesc projNames[],
+							const int predCnt,
+							const ScanPredicate preds[],
+							const Connective conn,
+							const int reclen,
+							const AttrDesc bitmapAttrs[]);
 
 /*
  * Selects records from the specified relation.
@@ -37,6 +83,8 @@ const Status QU_Select(const string & result,
 	const char* filter;
 	int intVal;
     float floatVal;
+    ScanPredicate pred;
+    int predCnt = 0;
 
     for (int i = 0; i < projCnt; i++) {
     	status = attrCat->getInfo(string(projNames[i].relName),string(projNames[i].attrName), projNamesDesc[i]);
@@ -71,78 +119,1170 @@ const Status QU_Select(const string & result,
 
                 break;           
         }	
-    } else {
-    	attrDesc.attrOffset = 0;
-        attrDesc.attrLen = 0;
-    	attrDesc.attrType = STRING;
-    	filter = NULL;
+
+		pred.offset = attrDesc.attrOffset;
+		pred.length = attrDesc.attrLen;
+		pred.type = (Datatype)attrDesc.attrType;
+		pred.filter = filter;
+		pred.op = op;
+		predCnt = 1;
     }
+
+	bool rejected;
+
+	status = QU_FilterRejects(string(projNames[0].relName), predCnt, &pred, CONJUNCTION,
+							  rejected);
+
+	if (status != OK || rejected) {
+		return status;
+	}
+
+	int which;
+	bool covered;
+
+	status = QU_CoveringIndex(string(projNames[0].relName), projCnt, projNamesDesc,
+							  predCnt, &pred, CONJUNCTION, covered, which, attrDesc);
+
+	if (status != OK) {
+		return status;
+	}
+
+	if (covered) {
+		return IndexOnlySelect(result, projCnt, projNamesDesc, predCnt, &pred, reclen,
+							   which, attrDesc);
+	}
+
+	status = QU_ChooseIndex(string(projNames[0].relName), predCnt, &pred, CONJUNCTION,
+							which, attrDesc);
+
+	if (status != OK) {
+		return status;
+	}
+
+	if (which >= 0) {
+		return IndexSelect(result, projCnt, projNamesDesc, predCnt, &pred, reclen,
+						   which, attrDesc);
+	}
 	
-    return ScanSelect(result, projCnt, projNamesDesc, &attrDesc, op, filter, reclen);
+    return ScanSelect(result, projCnt, projNamesDesc, predCnt, &pred, CONJUNCTION, reclen,
+					  NOSAMPLE, 100, 0);
 }
 
 
-const Status ScanSelect(const string & result, 
-#include "stdio.h"
-#include "stdlib.h"
-							const int projCnt, 
-							const AttrDesc projNames[],
-							const AttrDesc *attrDesc, 
-							const Operator op, 
-							const char *filter,
-							const int reclen)
+/*
+ * Selects the records of a relation that satisfy all (CONJUNCTION) or
+ * any (DISJUNCTION) of several conditions, in a single scan.  With no
+ * conditions every record is selected.  A sample of percent of the
+ * records (BERNOULLI) or of the pages (SYSTEMSAMPLE) of the relation
+ * may be selected from instead, for an approximate result; the same
+ * seed gives the same sample.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_Select(const string & result, 
+						const int projCnt, 
+						const attrInfo projNames[],
+						const int condCnt,
+						const attrInfo conds[],
+						const Operator ops[],
+						const Connective conn,
+						const SampleMethod sample,
+						const double percent,
+						const unsigned int seed)
 {
-    cout << "Doing HeapFileScan Selection using ScanSelect()" << endl;
+    cout << "Doing QU_Select " << endl;
 
-	char recordData[reclen];
-	Record record;
-	record.data = (void *) recordData;
-	record.length = reclen;
 	Status status;
-	RID currRID;
-	Record currRec;
-	int tupleCount = 0;
-	RID newRID;
+    int reclen = 0;
+    AttrDesc projNamesDesc[projCnt];
+    ScanPredicate preds[MAXSCANPREDS];
+    int numbers[MAXSCANPREDS];
 
-	InsertFileScan resultRel(result,status);
+    for (int i = 0; i < projCnt; i++) {
+    	status = attrCat->getInfo(string(projNames[i].relName),string(projNames[i].attrName), projNamesDesc[i]);
+    	
+		if (status != OK) {  
+			return status; 
+		}
 
-	if (status != OK){
+    	reclen += projNamesDesc[i].attrLen;
+    }
+
+	if (condCnt > 0) {
+		status = QU_MakePredicates(string(projNames[0].relName), condCnt, conds, ops, preds, numbers);
+
+		if (status != OK) {
+			return status;
+		}
+	}
+
+	bool rejected;
+
+	status = QU_FilterRejects(string(projNames[0].relName), condCnt, preds, conn, rejected);
+
+	if (status != OK || rejected) {
 		return status;
 	}
-	
-	HeapFileScan heapfileobj(string(projNames[0].relName), status);
+
+	// a sample is taken from a scan
+	if (sample == NOSAMPLE) {
+		int which;
+		AttrDesc indexAttr;
+		bool covered;
+
+		status = QU_CoveringIndex(string(projNames[0].relName), projCnt, projNamesDesc,
+								  condCnt, preds, conn, covered, which, indexAttr);
+
+		if (status != OK) {
+			return status;
+		}
+
+		if (covered) {
+			return IndexOnlySelect(result, projCnt, projNamesDesc, condCnt, preds, reclen,
+								   which, indexAttr);
+		}
+
+		int bitmapCnt;
+		AttrDesc bitmapAttrs[MAXSCANPREDS];
+
+		status = QU_ChooseBitmaps(string(projNames[0].relName), condCnt, preds, conn,
+								  bitmapCnt, bitmapAttrs);
+
+		if (status != OK) {
+			return status;
+		}
+
+		if (bitmapCnt > 0) {
+			return BitmapSelect(result, projCnt, projNamesDesc, condCnt, preds, conn,
+								reclen, bitmapAttrs);
+		}
+
+		status = QU_ChooseIndex(string(projNames[0].relName), condCnt, preds, conn,
+								which, indexAttr);
+
+		if (status != OK) {
+			return status;
+		}
+
+		if (which >= 0) {
+			return IndexSelect(result, projCnt, projNamesDesc, condCnt, preds, reclen,
+							   which, indexAttr);
+		}
+	}
+
+    return ScanSelect(result, projCnt, projNamesDesc, condCnt, preds, conn, reclen,
+					  sample, percent, seed);
+}
+
+
+/*
+ * Turns condCnt conditions "conds[i] ops[i] conds[i].attrValue" on the
+ * attributes of relation into scan predicates.  The values are text,
+ * as for QU_Insert; INTEGER and FLOAT values are converted into
+ * numbers[], which must be kept as long as the predicates are used.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_MakePredicates(const string & relation,
+								const int condCnt,
+								const attrInfo conds[],
+								const Operator ops[],
+								ScanPredicate preds[],
+								int numbers[])
+{
+	Status status;
+	AttrDesc attrDesc;
+	float floatVal;
+
+	if (condCnt < 1 || condCnt > MAXSCANPREDS) {
+		return BADSCANPARM;
+	}
+
+	for (int i = 0; i < condCnt; i++) {
+		status = attrCat->getInfo(relation, string(conds[i].attrName), attrDesc);
+
+		if (status != OK) {
+			return status;
+		}
+
+		preds[i].offset = attrDesc.attrOffset;
+		preds[i].length = attrDesc.attrLen;
+		preds[i].type = (Datatype)attrDesc.attrType;
+		preds[i].op = ops[i];
+
+		switch (attrDesc.attrType) {
+			case INTEGER:
+				numbers[i] = atoi((char *)conds[i].attrValue);
+				preds[i].filter = (char *)&numbers[i];
+
+				break;
+			case FLOAT:
+				floatVal = atof((char *)conds[i].attrValue);
+				memcpy(&numbers[i], &floatVal, sizeof(float));
+				preds[i].filter = (char *)&numbers[i];
+
+				break;
+			default:
+				preds[i].filter = (char *)conds[i].attrValue;
+
+				break;
+		}
+	}
+
+	return OK;
+}
+
+
+// the number held by an INTEGER or FLOAT statistics key
+static double KeyValue(const int type, const char *key)
+{
+	int intVal;
+	float floatVal;
+
+	if (type == INTEGER) {
+		memcpy(&intVal, key, sizeof(int));
+
+		return intVal;
+	}
+
+	memcpy(&floatVal, key, sizeof(float));
+
+	return floatVal;
+}
+
+
+// estimate from the statistics of attribute ad how many records of
+// its relation satisfy pred, and how many pages the relation has.
+// NOSTATS if the attribute has not been analyzed
+
+static const Status EstimateMatches(const AttrDesc & ad,
+									const ScanPredicate & pred,
+									double & rows,
+									int & pageCnt)
+{
+	Status status;
+	StatDesc sd;
+	double fraction;
+
+	status = statCat->getInfo(ad.relName, ad.attrName, sd);
 
 	if (status != OK) {
 		return status;
 	}
 
-	status = heapfileobj.startScan(attrDesc->attrOffset, attrDesc->attrLen, (Datatype)attrDesc->attrType, filter, op);
+	pageCnt = sd.pageCnt;
 
-	if (status != OK) { 
+	if (sd.bucketCnt == 0) {
+		rows = 0;
+
+		return OK;
+	}
+
+	if (pred.op == EQ || pred.op == NE) {
+		fraction = 1 / (sd.distinctCnt > 1 ? sd.distinctCnt : 1);
+
+		if (pred.op == NE) {
+			fraction = 1 - fraction;
+		}
+	} else {
+		// the rows below the value are those of the histogram buckets
+		// wholly below it and a share of those of the bucket it is in,
+		// by interpolation for numbers and half for strings
+		char key[STATKEYLEN];
+		double below;
+
+		zoneKey(ad.attrType, pred.filter, pred.length, key);
+
+		if (zoneCmp(ad.attrType, key, sd.bounds[0]) < 0) {
+			below = 0;
+		} else if (zoneCmp(ad.attrType, key, sd.bounds[sd.bucketCnt]) > 0) {
+			below = 1;
+		} else {
+			int b = 0;
+
+			while (b < sd.bucketCnt - 1 && zoneCmp(ad.attrType, key, sd.bounds[b + 1]) >= 0) {
+				b++;
+			}
+
+			double share = 0.5;
+
+			if (ad.attrType != STRING) {
+				double v = KeyValue(ad.attrType, key);
+				double lo = KeyValue(ad.attrType, sd.bounds[b]);
+				double hi = KeyValue(ad.attrType, sd.bounds[b + 1]);
+
+				share = hi > lo ? (v - lo) / (hi - lo) : 1;
+			}
+
+			below = (b + share) / sd.bucketCnt;
+		}
+
+		fraction = (pred.op == LT || pred.op == LTE) ? below : 1 - below;
+	}
+
+	rows = fraction * sd.rowCnt;
+
+	return OK;
+}
+
+
+/*
+ * Picks the predicate of a selection on relation that an index is to
+ * answer: one that every selected record satisfies (any of a
+ * CONJUNCTION, or the only one), on an indexed attribute, with an
+ * operator its index answers.  If the attribute has been analyzed, the
+ * predicate must be estimated to let few enough records through for
+ * looking them up one by one to beat a scan; the one letting the
+ * fewest through is picked.  On attributes without statistics only an
+ * equality, taken to let few records through, is answered by the index,
+ * after any predicate with an estimate.  which is set to the position of the
+ * predicate and indexAttr to its attribute, or which to -1 if the
+ * relation is to be scanned.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_ChooseIndex(const string & relation,
+							const int predCnt,
+							const ScanPredicate preds[],
+							const Connective conn,
+							int & which,
+							AttrDesc & indexAttr)
+{
+	Status status = OK;
+	AttrDesc *attrs;
+	int attrCnt;
+	double best = -1;
+
+	which = -1;
+
+	if (predCnt < 1 || (predCnt > 1 && conn != CONJUNCTION)) {
+		return OK;
+	}
+
+	status = attrCat->getRelInfo(relation, attrCnt, attrs);
+
+	if (status != OK) {
 		return status;
 	}
 
-	while (heapfileobj.scanNext(currRID) == OK) {
-		status = heapfileobj.getRecord(currRec);
+	for (int i = 0; i < predCnt && status == OK; i++) {
+		for (int j = 0; j < attrCnt; j++) {
+			if (attrs[j].attrOffset != preds[i].offset ||
+				!indexAnswers((IndexType)attrs[j].indexed, preds[i].op)) {
+				continue;
+			}
 
-		if (status == OK) {
-			int recordOffset = 0;
-			
-			for (int i = 0; i < projCnt; i++) {
-				memcpy(recordData + recordOffset,
-				(char *)currRec.data + projNames[i].attrOffset,
-				projNames[i].attrLen);
+			double rows;
+			int pageCnt;
+			double cost;
 
-				recordOffset += projNames[i].attrLen;
+			status = EstimateMatches(attrs[j], preds[i], rows, pageCnt);
+
+			if (status == NOSTATS) {
+				// a range may let any part of the relation through
+				status = OK;
+
+				if (preds[i].op != EQ) {
+					break;
+				}
+
+				cost = 1e30;
+			} else if (status != OK || rows * INDEXPAGEFRACTION > pageCnt) {
+				break;
+			} else {
+				cost = rows;
+			}
+
+			if (which < 0 || cost < best) {
+				which = i;
+				best = cost;
+				indexAttr = attrs[j];
+			}
+
+			break;
+		}
+	}
+
+	free(attrs);
+
+	return status;
+}
+
+
+/*
+ * Sees if an index covers a selection, that is answers it without the
+ * records of the relation: all predCnt predicates and all projCnt
+ * projected attributes must be on the indexed attribute.  which is set
+ * to the predicate the index is scanned for, an equality one if there
+ * is one, or to -1 if a B+-tree must be scanned whole.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_CoveringIndex(const string & relation,
+							  const int projCnt,
+							  const AttrDesc projNames[],
+							  const int predCnt,
+							  const ScanPredicate preds[],
+							  const Connective conn,
+							  bool & covered,
+							  int & which,
+							  AttrDesc & indexAttr)
+{
+	Status status;
+	AttrDesc *attrs;
+	int attrCnt;
+	int width = 0;
+
+	covered = false;
+	which = -1;
+	indexAttr.indexed = UNINDEXED;
+
+	if (projCnt < 1 || (predCnt > 1 && conn != CONJUNCTION)) {
+		return OK;
+	}
+
+	status = attrCat->getRelInfo(relation, attrCnt, attrs);
+
+	if (status != OK) {
+		return status;
+	}
+
+	for (int j = 0; j < attrCnt; j++) {
+		width += attrs[j].attrLen;
+
+		if (attrs[j].attrOffset == projNames[0].attrOffset) {
+			indexAttr = attrs[j];
+		}
+	}
+
+	free(attrs);
+
+	if (indexAttr.indexed == UNINDEXED) {
+		return OK;
+	}
+
+	for (int i = 1; i < projCnt; i++) {
+		if (projNames[i].attrOffset != indexAttr.attrOffset) {
+			return OK;
+		}
+	}
+
+	for (int i = 0; i < predCnt; i++) {
+		if (preds[i].offset != indexAttr.attrOffset) {
+			return OK;
+		}
+
+		if (indexAnswers((IndexType)indexAttr.indexed, preds[i].op) &&
+			(which < 0 || (preds[i].op == EQ && preds[which].op != EQ))) {
+			which = i;
+		}
+	}
+
+	// with no predicate to scan for, the leaves are read in place of
+	// the heap, which pays only if they are fewer
+	covered = which >= 0 ||
+		(indexAttr.indexed == BTREEINDEX &&
+		 indexAttr.attrLen + (int)sizeof(RID) < width);
+
+	return OK;
+}
+
+/*
+ * Sees if the bitmap indices of a relation answer a selection with
+ * several predicates together: at least two of a CONJUNCTION, whose
+ * bitmaps are ANDed, or all of a DISJUNCTION, whose bitmaps are ORed.
+ * bitmapAttrs[i] is set to the attribute of predicate i if a bitmap
+ * index answers it, and its indexed to UNINDEXED otherwise; bitmapCnt
+ * to the number answered, or to 0 if the bitmaps are not to be used.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_ChooseBitmaps(const string & relation,
+							  const int predCnt,
+							  const ScanPredicate preds[],
+							  const Connective conn,
+							  int & bitmapCnt,
+							  AttrDesc bitmapAttrs[])
+{
+	Status status;
+	AttrDesc *attrs;
+	int attrCnt;
+
+	bitmapCnt = 0;
+
+	if (predCnt < 2) {
+		return OK;
+	}
+
+	status = attrCat->getRelInfo(relation, attrCnt, attrs);
+
+	if (status != OK) {
+		return status;
+	}
+
+	for (int i = 0; i < predCnt; i++) {
+		bitmapAttrs[i].indexed = UNINDEXED;
+
+		for (int j = 0; j < attrCnt; j++) {
+			if (attrs[j].attrOffset == preds[i].offset &&
+				attrs[j].indexed == BITMAPINDEX) {
+				bitmapAttrs[i] = attrs[j];
+				bitmapCnt++;
 			}
-		} else {
-			return status;
 		}
+	}
+
+	free(attrs);
 
-		status = resultRel.insertRecord(record, newRID);
-		ASSERT(status == OK);
-		tupleCount++;
+	if ((conn == CONJUNCTION && bitmapCnt < 2) ||
+		(conn == DISJUNCTION && bitmapCnt < predCnt)) {
+		bitmapCnt = 0;
 	}
 
 	return OK;
-}
\ No newline at end of file
+}
+
+/*
+ * Sees if the Bloom filters of a relation show that no record
+ * satisfies a selection, so that it need not read any: a CONJUNCTION
+ * is rejected if the filter on the attribute of any of its EQ
+ * predicates rules out the value, a DISJUNCTION if all of its
+ * predicates are EQ on filtered attributes and all values are ruled
+ * out.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_FilterRejects(const string & relation,
+							  const int predCnt,
+							  const ScanPredicate preds[],
+							  const Connective conn,
+							  bool & rejected)
+{
+	Status status;
+	AttrDesc *attrs;
+	int attrCnt;
+	int ruledOut = 0;
+
+	rejected = false;
+
+	if (predCnt == 0) {
+		return OK;
+	}
+
+	status = attrCat->getRelInfo(relation, attrCnt, attrs);
+
+	if (status != OK) {
+		return status;
+	}
+
+	for (int i = 0; i < predCnt && status == OK; i++) {
+		if (preds[i].op != EQ) {
+			continue;
+		}
+
+		for (int j = 0; j < attrCnt; j++) {
+			if (attrs[j].attrOffset != preds[i].offset || !attrs[j].filtered) {
+				continue;
+			}
+
+			BloomFilter filter(filterFileName(relation, attrs[j].attrName), status);
+			bool found;
+
+			if (status == OK) {
+				status = filter.mayContain(preds[i].filter, found);
+			}
+
+			if (status == OK && !found) {
+				ruledOut++;
+			}
+
+			break;
+		}
+	}
+
+	free(attrs);
+
+	if (status != OK) {
+		return status;
+	}
+
+	rejected = (conn == CONJUNCTION || predCnt == 1) ? ruledOut > 0 : ruledOut == predCnt;
+
+	if (rejected) {
+		cout << "Bloom filter rules out the selection, reading no heap pages" << endl;
+		cout << "Selected 0 tuples" << endl;
+	}
+
+	return OK;
+}
+
+// scale the tuple count of a sample up to the whole relation
+static void PrintSampleEstimate(const SampleMethod sample,
+								const double percent,
+								const int tupleCount)
+{
+	if (sample == NOSAMPLE) {
+		return;
+	}
+
+	cout << "Sampled " << percent << "% of the "
+		 << (sample == BERNOULLI ? "tuples" : "pages") << ", about "
+		 << (long)(tupleCount * 100 / percent + 0.5)
+		 << " tuples in the relation qualify" << endl;
+}
+
+
+const Status ScanSelect(const string & result, 
+							const int projCnt, 
+							const AttrDesc projNames[],
+							const int predCnt,
+							const ScanPredicate preds[],
+							const Connective conn,
+							const int reclen,
+							const SampleMethod sample,
+							const double percent,
+							const unsigned int seed)
+{
+    cout << "Doing HeapFileScan Selection using ScanSelect()" << endl;
+
+	char recordData[reclen * SCANBATCHSIZE];
+	Status status;
+	int tupleCount = 0;
+	int projOffsets[projCnt];
+	int projLengths[projCnt];
+
+	for (int i = 0; i < projCnt; i++) {
+		projOffsets[i] = projNames[i].attrOffset;
+		projLengths[i] = projNames[i].attrLen;
+	}
+
+	InsertFileScan resultRel(result,status);
+
+	if (status != OK){
+		return status;
+	}
+
+	// with more than one thread the relation is scanned in parallel
+	if (ScanThreads > 1) {
+		cout << "Scanning with " << ScanThreads << " threads" << endl;
+
+		ParallelScan parScan(string(projNames[0].relName), ScanThreads, status);
+
+		if (status != OK) {
+			return status;
+		}
+
+		status = parScan.setSample(sample, percent, seed);
+
+		if (status != OK) {
+			return status;
+		}
+
+		status = parScan.run(&resultRel, predCnt, preds, conn,
+							 projCnt, projOffsets, projLengths, tupleCount);
+
+		if (status != OK) {
+			return status;
+		}
+
+		const ScanStats & stats = parScan.getScanStats();
+		cout << "Selected " << tupleCount << " tuples, skipped "
+			 << stats.pagesSkipped << " of "
+			 << stats.pagesScanned + stats.pagesSkipped << " pages" << endl;
+		PrintSampleEstimate(sample, percent, tupleCount);
+
+		return OK;
+	}
+	
+	HeapFileScan heapfileobj(string(projNames[0].relName), status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = heapfileobj.setSample(sample, percent, seed);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = heapfileobj.startScan(predCnt, preds, conn);
+
+	if (status != OK) { 
+		return status;
+	}
+
+	RID rids[SCANBATCHSIZE];
+	Record outRecs[SCANBATCHSIZE];
+	int batchCnt;
+
+	for (int j = 0; j < SCANBATCHSIZE; j++) {
+		outRecs[j].data = recordData + j * reclen;
+		outRecs[j].length = reclen;
+	}
+
+	// only the projected attributes of qualifying rows are read
+	while ((status = heapfileobj.scanNextFields(SCANBATCHSIZE, rids, projCnt, projOffsets,
+												projLengths, recordData, batchCnt)) == OK) {
+		// and inserted a batch at a time
+		status = resultRel.insertBatch(outRecs, batchCnt, rids);
+
+		if (status != OK) {
+			return status;
+		}
+
+		tupleCount += batchCnt;
+	}
+
+	if (status != FILEEOF) {
+		return status;
+	}
+
+	const ScanStats & stats = heapfileobj.getScanStats();
+	cout << "Selected " << tupleCount << " tuples, skipped "
+		 << stats.pagesSkipped << " of "
+		 << stats.pagesScanned + stats.pagesSkipped << " pages" << endl;
+	PrintSampleEstimate(sample, percent, tupleCount);
+
+	return OK;
+}
+
+
+// select with the open index of IndexSelect()
+static const Status FetchSelect(const string & result, 
+								const int projCnt, 
+								const AttrDesc projNames[],
+								const int predCnt,
+								const ScanPredicate preds[],
+								const int reclen,
+								const int which,
+								const AttrDesc & indexAttr,
+								Index & index)
+{
+	char recordData[reclen * SCANBATCHSIZE];
+	Status status;
+	int tupleCount = 0;
+	int entryCount = 0;
+	MatchFn matchFns[predCnt];
+
+	for (int i = 0; i < predCnt; i++) {
+		matchFns[i] = compilePredicate(preds[i].type, preds[i].op);
+	}
+
+	InsertFileScan resultRel(result, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	HeapFile heapfileobj(string(indexAttr.relName), status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = index.startScan(preds[which].filter, preds[which].op);
+
+	if (status != OK) {
+		return status;
+	}
+
+	RID rids[INDEXFETCHBATCH];
+	RID outRids[SCANBATCHSIZE];
+	Record outRecs[SCANBATCHSIZE];
+	int outCnt = 0;
+	bool more = true;
+
+	while (more) {
+		int ridCnt = 0;
+
+		while (ridCnt < INDEXFETCHBATCH && (status = index.scanNext(rids[ridCnt])) == OK) {
+			ridCnt++;
+		}
+
+		if (status == NOMORERECS) {
+			more = false;
+		} else if (status != OK) {
+			return status;
+		}
+
+		entryCount += ridCnt;
+
+		// in page order each page is read once
+		sort(rids, rids + ridCnt, ridLess);
+
+		for (int k = 0; k < ridCnt; k++) {
+			Record rec;
+			bool match = true;
+
+			status = heapfileobj.getRecord(rids[k], rec);
+
+			if (status != OK) {
+				return status;
+			}
+
+			for (int i = 0; i < predCnt && match; i++) {
+				match = (*matchFns[i])((char *)rec.data + preds[i].offset,
+									   preds[i].filter, preds[i].length);
+			}
+
+			if (!match) {
+				continue;
+			}
+
+			char *offset = recordData + outCnt * reclen;
+
+			outRecs[outCnt].data = offset;
+			outRecs[outCnt].length = reclen;
+
+			for (int i = 0; i < projCnt; i++) {
+				memcpy(offset, (char *)rec.data + projNames[i].attrOffset,
+					   projNames[i].attrLen);
+				offset += projNames[i].attrLen;
+			}
+
+			if (++outCnt == SCANBATCHSIZE) {
+				status = resultRel.insertBatch(outRecs, outCnt, outRids);
+
+				if (status != OK) {
+					return status;
+				}
+
+				tupleCount += outCnt;
+				outCnt = 0;
+			}
+		}
+	}
+
+	if (outCnt > 0) {
+		status = resultRel.insertBatch(outRecs, outCnt, outRids);
+
+		if (status != OK) {
+			return status;
+		}
+
+		tupleCount += outCnt;
+	}
+
+	cout << "Selected " << tupleCount << " tuples from " << entryCount
+		 << " index entries" << endl;
+
+	return index.endScan();
+}
+
+
+/*
+ * Selects the records that satisfy all of predCnt predicates with the
+ * index on the attribute of predicate which: the index is scanned for
+ * the records satisfying that one, which are then read in page order
+ * and checked against the others.
+ */
+
+const Status IndexSelect(const string & result, 
+							const int projCnt, 
+							const AttrDesc projNames[],
+							const int predCnt,
+							const ScanPredicate preds[],
+							const int reclen,
+							const int which,
+							const AttrDesc & indexAttr)
+{
+    cout << "Doing index selection using IndexSelect() on "
+		 << indexAttr.attrName << endl;
+
+	Status status;
+	Index *index;
+
+	status = openIndex(indexAttr, index);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = FetchSelect(result, projCnt, projNames, predCnt, preds, reclen,
+						 which, indexAttr, *index);
+	delete index;
+
+	return status;
+}
+
+
+/*
+ * Selects with an index alone, for a selection it covers (see
+ * QU_CoveringIndex): the index is scanned for predicate which, or
+ * whole if which is -1, and the keys of the entries that satisfy all
+ * predicates make up the result.  No page of the relation is read.  A
+ * B+-tree scan stops at the first key past an upper bound.
+ */
+
+const Status IndexOnlySelect(const string & result, 
+							const int projCnt, 
+							const AttrDesc projNames[],
+							const int predCnt,
+							const ScanPredicate preds[],
+							const int reclen,
+							const int which,
+							const AttrDesc & indexAttr)
+{
+    cout << "Doing index-only selection using IndexOnlySelect() on "
+		 << indexAttr.attrName << endl;
+
+	char recordData[reclen * SCANBATCHSIZE];
+	char key[indexAttr.attrLen];
+	Status status;
+	int tupleCount = 0;
+	int entryCount = 0;
+	MatchFn matchFns[predCnt];
+	Index *index;
+
+	for (int i = 0; i < predCnt; i++) {
+		matchFns[i] = compilePredicate(preds[i].type, preds[i].op);
+	}
+
+	InsertFileScan resultRel(result, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = openIndex(indexAttr, index);
+
+	if (status != OK) {
+		return status;
+	}
+
+	if (which >= 0) {
+		status = index->startScan(preds[which].filter, preds[which].op);
+	} else {
+		status = ((BTreeIndex *)index)->startScan(NULL, false, NULL, false);
+	}
+
+	RID rid;
+	RID outRids[SCANBATCHSIZE];
+	Record outRecs[SCANBATCHSIZE];
+	int outCnt = 0;
+
+	while (status == OK && (status = index->scanNextEntry(rid, key)) == OK) {
+		bool match = true;
+
+		entryCount++;
+
+		for (int i = 0; i < predCnt && match; i++) {
+			match = (*matchFns[i])(key, preds[i].filter, preds[i].length);
+
+			// the keys of a B+-tree come in order, so none after one
+			// above an upper bound is below it
+			if (!match && indexAttr.indexed == BTREEINDEX &&
+				(preds[i].op == LT || preds[i].op == LTE)) {
+				status = NOMORERECS;
+			}
+		}
+
+		if (status == NOMORERECS) {
+			break;
+		}
+
+		if (!match) {
+			continue;
+		}
+
+		// every projected attribute is the key
+		char *offset = recordData + outCnt * reclen;
+
+		outRecs[outCnt].data = offset;
+		outRecs[outCnt].length = reclen;
+
+		for (int i = 0; i < projCnt; i++) {
+			memcpy(offset, key, projNames[i].attrLen);
+			offset += projNames[i].attrLen;
+		}
+
+		if (++outCnt == SCANBATCHSIZE) {
+			status = resultRel.insertBatch(outRecs, outCnt, outRids);
+			tupleCount += outCnt;
+			outCnt = 0;
+		}
+	}
+
+	if (status == NOMORERECS && outCnt > 0) {
+		status = resultRel.insertBatch(outRecs, outCnt, outRids);
+		tupleCount += outCnt;
+	}
+
+	if (status == NOMORERECS || status == OK) {
+		status = index->endScan();
+	}
+
+	delete index;
+
+	if (status != OK) {
+		return status;
+	}
+
+	cout << "Selected " << tupleCount << " tuples from " << entryCount
+		 << " index entries, reading no heap pages" << endl;
+
+	return OK;
+}
+
+
+/*
+ * Selects with bitmap indices (see QU_ChooseBitmaps): the bitmaps of
+ * the records satisfying the predicates they answer are combined
+ * before any record is read, and the records left are then read in
+ * page order, each page once, and checked against all predicates.
+ */
+
+const Status BitmapSelect(const string & result, 
+							const int projCnt, 
+							const AttrDesc projNames[],
+							const int predCnt,
+							const ScanPredicate preds[],
+							const Connective conn,
+							const int reclen,
+							const AttrDesc bitmapAttrs[])
+{
+	char recordData[reclen * SCANBATCHSIZE];
+	Status status;
+	int tupleCount = 0;
+	int bitmapCnt = 0;
+	MatchFn matchFns[predCnt];
+	Bitmap bits;
+
+	for (int i = 0; i < predCnt; i++) {
+		matchFns[i] = compilePredicate(preds[i].type, preds[i].op);
+	}
+
+	for (int i = 0; i < predCnt; i++) {
+		Index *index;
+		Bitmap predBits;
+
+		if (bitmapAttrs[i].indexed != BITMAPINDEX) {
+			continue;
+		}
+
+		status = openIndex(bitmapAttrs[i], index);
+
+		if (status != OK) {
+			return status;
+		}
+
+		status = ((BitmapIndex *)index)->getBitmap(preds[i].filter, preds[i].op, predBits);
+		delete index;
+
+		if (status != OK) {
+			return status;
+		}
+
+		if (bitmapCnt++ == 0) {
+			bits = predBits;
+		} else {
+			Bitmap out;
+
+			Bitmap::combine(bits, predBits, conn == CONJUNCTION, out);
+			bits = out;
+		}
+	}
+
+    cout << "Doing bitmap selection using BitmapSelect() on " << bitmapCnt
+		 << " bitmaps" << endl;
+
+	InsertFileScan resultRel(result, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	HeapFile heapfileobj(string(projNames[0].relName), status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	RID outRids[SCANBATCHSIZE];
+	Record outRecs[SCANBATCHSIZE];
+	int outCnt = 0;
+	int pos;
+
+	// the bits come in page order
+	bits.startScan();
+
+	while (bits.scanNext(pos)) {
+		Record rec;
+		RID rid;
+		bool match = conn == CONJUNCTION;
+
+		rid.pageNo = pos / BITMAPPAGESLOTS;
+		rid.slotNo = pos % BITMAPPAGESLOTS;
+
+		status = heapfileobj.getRecord(rid, rec);
+
+		if (status != OK) {
+			return status;
+		}
+
+		for (int i = 0; i < predCnt && match == (conn == CONJUNCTION); i++) {
+			match = (*matchFns[i])((char *)rec.data + preds[i].offset,
+								   preds[i].filter, preds[i].length);
+		}
+
+		if (!match) {
+			continue;
+		}
+
+		char *offset = recordData + outCnt * reclen;
+
+		outRecs[outCnt].data = offset;
+		outRecs[outCnt].length = reclen;
+
+		for (int i = 0; i < projCnt; i++) {
+			memcpy(offset, (char *)rec.data + projNames[i].attrOffset,
+				   projNames[i].attrLen);
+			offset += projNames[i].attrLen;
+		}
+
+		if (++outCnt == SCANBATCHSIZE) {
+			status = resultRel.insertBatch(outRecs, outCnt, outRids);
+
+			if (status != OK) {
+				return status;
+			}
+
+			tupleCount += outCnt;
+			outCnt = 0;
+		}
+	}
+
+	if (outCnt > 0) {
+		status = resultRel.insertBatch(outRecs, outCnt, outRids);
+
+		if (status != OK) {
+			return status;
+		}
+
+		tupleCount += outCnt;
+	}
+
+	cout << "Selected " << tupleCount << " tuples from " << bits.getSetCnt()
+		 << " bitmap entries" << endl;
+
+	return OK;
+}
@@ -8,14 +8,16 @@
 
 
 // SORTREC is an in-memory sort record that qsort(3) sorts.
-// The sort attribute as well as the associated RID are
-// stored in the record. The RID is used for fetching the
-// full record when it is needed.
+// A copy of the source record is kept with it, so that a
+// sorted run is written without reading the source again,
+// along with a pointer to the sort attribute in the copy.
 
 typedef struct {
   RID rid;                              // record id of current record
   char* field;                          // pointer to field
   int length;                           // length of field
+  char* data;                           // copy of the record
+  int dataLength;                       // length of the record
 } SORTREC;
 
 
@@ -48,12 +50,12 @@ class SortedFile {
 
   vector<RUN> runs;                   // holds info about each sub-run
 
-  HeapFile* hfile;                   // source file to sort
   HeapFileScan* hfs;                   // source file to sort
   string fileName;                      // name of source file to sort
   Datatype type;                        // type of sort attribute
   int offset;                           // offset of sort attribute
   int length;                           // length of sort attribute
+  CompareFn reccmp;                     // compares two sort attributes
 
   SORTREC* buffer;                      // in-memory sort buffer
   int maxItems;                         // max. # of items/tuples in buffer
@@ -0,0 +1,156 @@
+#include "catalog.h"
+#include "query.h"
+#include "index.h"
+
+
+/*
+ * Updates the records of a relation that satisfy all (CONJUNCTION) or
+ * any (DISJUNCTION) of condCnt conditions, setting the attributes in
+ * setList to the values given with them.  Values are text, as for
+ * QU_Insert.  Every record is changed in place during a single scan,
+ * so it keeps its RID and the relation does not grow.  With no
+ * conditions all records are updated.  The entries of changed values
+ * are changed in the indices of the relation.
+ *
+ * Returns:
+ * 	OK on success
+ * 	an error code otherwise
+ */
+
+const Status QU_Update(const string & relation,
+						const int setCnt,
+						const attrInfo setList[],
+						const int condCnt,
+						const attrInfo conds[],
+						const Operator ops[],
+						const Connective conn)
+{
+	if (relation.empty() || setCnt < 1) {
+		return BADCATPARM;
+	}
+
+	Status status;
+	RID rid;
+	ScanPredicate preds[MAXSCANPREDS];
+	int numbers[MAXSCANPREDS];
+	int offsets[setCnt];
+	int lengths[setCnt];
+	Datatype types[setCnt];
+	int valueLen = 0;
+	int tupleCount = 0;
+
+	if (condCnt > 0) {
+		status = QU_MakePredicates(relation, condCnt, conds, ops, preds, numbers);
+
+		if (status != OK) {
+			return status;
+		}
+	}
+
+	// look up the attributes to set and the space their new values take
+	for (int i = 0; i < setCnt; i++) {
+		AttrDesc attrDesc;
+
+		status = attrCat->getInfo(relation, string(setList[i].attrName), attrDesc);
+
+		if (status != OK) {
+			return status;
+		}
+
+		offsets[i] = attrDesc.attrOffset;
+		lengths[i] = attrDesc.attrLen;
+		types[i] = (Datatype)attrDesc.attrType;
+		valueLen += attrDesc.attrLen;
+	}
+
+	// convert the new values once, in the layout of the tuples
+	char values[valueLen];
+	char *value = values;
+
+	for (int i = 0; i < setCnt; i++) {
+		int intVal;
+		float floatVal;
+
+		switch (types[i]) {
+			case INTEGER:
+				intVal = atoi((char *)setList[i].attrValue);
+				memcpy(value, &intVal, sizeof(int));
+
+				break;
+
+			case FLOAT:
+				floatVal = atof((char *)setList[i].attrValue);
+				memcpy(value, &floatVal, sizeof(float));
+
+				break;
+
+			default:
+				memset(value, 0, lengths[i]);
+				strncpy(value, (char *)setList[i].attrValue, lengths[i]);
+
+				break;
+		}
+
+		value += lengths[i];
+	}
+
+	RelIndices indices(relation, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	HeapFileScan scanner(relation, status);
+
+	if (status != OK) {
+		return status;
+	}
+
+	status = scanner.startScan(condCnt, preds, conn);
+
+	if (status != OK) {
+		return status;
+	}
+
+	vector<char> oldData;
+
+	while ((status = scanner.scanNext(rid)) == OK) {
+		Record oldRec, newRec;
+
+		// the old values are kept for the indices
+		if (indices.getIndexCnt() > 0) {
+			status = scanner.getRecord(oldRec);
+
+			if (status != OK) {
+				return status;
+			}
+
+			oldData.assign((char *)oldRec.data, (char *)oldRec.data + oldRec.length);
+			oldRec.data = &oldData[0];
+		}
+
+		status = scanner.updateFields(setCnt, offsets, lengths, values);
+
+		if (status == OK && indices.getIndexCnt() > 0) {
+			status = scanner.getRecord(newRec);
+
+			if (status == OK) {
+				status = indices.updateEntries(oldRec, newRec, rid);
+			}
+		}
+
+		if (status != OK) {
+			return status;
+		}
+
+		tupleCount++;
+	}
+
+	if (status != FILEEOF) {
+		return status;
+	}
+
+	cout << "Updated " << tupleCount << " tuples" << endl;
+
+	return scanner.endScan();
+}
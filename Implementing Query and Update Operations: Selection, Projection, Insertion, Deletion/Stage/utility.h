@@ -27,6 +27,13 @@ const Status UT_Load(const string & relation,
 
 const Status UT_Print(string relation);
 
+const Status UT_Vacuum(const string & relation,
+		       const int maxPages);
+
+const Status UT_Analyze(const string & relation,
+			const double percent,
+			const bool incremental);
+
 void   UT_Quit(void);
 
 #endif